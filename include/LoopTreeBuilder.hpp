@@ -1,6 +1,30 @@
 #pragma once
 #include "graph.hpp"
+#include "loopForest.hpp"
 
 namespace Analysis {
-template <typename NodeT> void buildLoopTree(G::Graph<NodeT, int> *g, G::Graph<G::Cycle, int> *loops) {}
-}
\ No newline at end of file
+/// @brief loops graph from a loop forest: node per loop keyed by header key w/ Cycle data,
+/// edges outer -> inner loop; blocks outside of loops go to root loop root_loop_key
+/// that is linked to the outermost loops. Loop nodes refer to Cycle data kept in cycles
+void buildLoopTree(const G::CsrGraph &view, const G::LoopForest &forest,
+                   G::Graph<G::Cycle, int> *loops, std::vector<G::Cycle> &cycles,
+                   G::key_t root_loop_key);
+
+/// @brief loop nesting forest of g from root; reducible & irreducible loops are found,
+/// Node::m_loop is set to the header key of the innermost loop (KEY_UNDEF outside of loops)
+template <typename N, typename E>
+void buildLoopTree(G::Graph<N, E> *g, G::Graph<G::Cycle, int> *loops,
+                   std::vector<G::Cycle> &cycles, G::key_t root_key = 1) {
+    if (g == nullptr || loops == nullptr) {
+        return;
+    }
+    G::CsrGraph view = g->freeze();
+    G::LoopForest forest{};
+    forest.build(view.index(root_key), view);
+    buildLoopTree(view, forest, loops, cycles, g->get_avail_nd_key());
+    for (auto it = g->nodes_begin(); it != g->nodes_end(); ++it) {
+        G::idx_t header = forest.loop(view.index(it->first));
+        it->second->set_loop(header == G::IDX_UNDEF ? G::KEY_UNDEF : view.key(header));
+    }
+}
+} // namespace Analysis
@@ -0,0 +1,58 @@
+#pragma once
+#include "config.hpp"
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace IR {
+
+/// @brief bump-pointer allocator: objects are carved out of large chunks, memory goes back
+/// only all at once (O(chunks)). Destructors are not called - owner of objects runs them
+class Arena final {
+  public:
+    /// @brief HUGE_PAGES maps chunks w/ huge pages where the OS allows, plain pages otherwise
+    enum class ChunkSource { HEAP, HUGE_PAGES };
+    /// @brief one huge page
+    static constexpr size_t CHUNK_SIZE = size_t{2} << 20;
+
+    explicit Arena(ChunkSource source = ChunkSource::HEAP, size_t chunk_size = CHUNK_SIZE);
+    Arena(const Arena &) = delete;
+    Arena &operator=(const Arena &) = delete;
+    ~Arena();
+
+    void *allocate(size_t size, size_t align);
+    template <typename T, typename... Args> T *create(Args &&...args);
+    /// @brief free every chunk; objects must be destroyed beforehand
+    void release();
+
+    ChunkSource source() const;
+    size_t chunk_count() const;
+    /// @brief bytes handed out so far, padding included
+    size_t bytes_used() const;
+
+  private:
+    struct Chunk {
+        char *data;
+        size_t size;
+        // chunk came from mmap, not from operator new
+        bool mapped;
+    };
+    Chunk allocate_chunk_(size_t size);
+    void free_chunk_(const Chunk &chunk);
+
+  private:
+    ChunkSource m_source{ChunkSource::HEAP};
+    size_t m_chunk_size{CHUNK_SIZE};
+    std::vector<Chunk> m_chunks{};
+    char *m_cur{nullptr};
+    char *m_end{nullptr};
+    size_t m_used{0};
+};
+
+template <typename T, typename... Args> T *Arena::create(Args &&...args) {
+    void *ptr = allocate(sizeof(T), alignof(T));
+    return new (ptr) T(std::forward<Args>(args)...);
+}
+
+} // namespace IR
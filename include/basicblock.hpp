@@ -2,7 +2,8 @@
 #include "config.hpp"
 #include "types.hpp"
 #include "instruction.hpp"
-#include <list>
+#include <cstddef>
+#include <iterator>
 #include <sstream>
 #include <string>
 #include <utility>
@@ -15,14 +16,52 @@ struct InstrArgs {
     GroupType type{GroupType::UNDEF};
 };
 
+/// @brief walks instrs of bb along their own prev/next links; end is nullptr
+/// stays valid while the instr it points to is in the same bb
+template <typename T> class InstrListIt {
+  public:
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type = T *;
+    using difference_type = std::ptrdiff_t;
+    using pointer = T *const *;
+    using reference = T *;
+
+    InstrListIt() = default;
+    InstrListIt(T *node, T *const *last) : m_node(node), m_last(last) {}
+    T *operator*() const { return m_node; }
+    InstrListIt &operator++() {
+        m_node = static_cast<T *>(m_node->next());
+        return *this;
+    }
+    InstrListIt operator++(int) {
+        auto copy = *this;
+        ++*this;
+        return copy;
+    }
+    // end steps back to the last instr
+    InstrListIt &operator--() {
+        m_node = m_node ? static_cast<T *>(m_node->prev()) : *m_last;
+        return *this;
+    }
+    InstrListIt operator--(int) {
+        auto copy = *this;
+        --*this;
+        return copy;
+    }
+    bool operator==(const InstrListIt &other) const { return m_node == other.m_node; }
+    bool operator!=(const InstrListIt &other) const { return m_node != other.m_node; }
+
+  private:
+    T *m_node{nullptr};
+    T *const *m_last{nullptr};
+};
+
 class BasicBlock final {
   public:
-    using InstrCIt = typename std::list<Instr *>::const_iterator;
-    using PhyCIt = typename std::list<Phy *>::const_iterator;
-    using InstrIt = typename std::list<Instr *>::iterator;
-    using PhyIt = typename std::list<Phy *>::iterator;
-    using InstrContainer = std::list<Instr *>;
-    using PhyContainer = std::list<Phy *>;
+    using InstrIt = InstrListIt<Instr>;
+    using PhyIt = InstrListIt<Phy>;
+    using InstrCIt = InstrIt;
+    using PhyCIt = PhyIt;
     using ConstInstrInitList = std::initializer_list<const Instr *>;
     using InstrInitList = std::initializer_list<Instr*>;
     using PhyInitList = std::initializer_list<Phy*>;
@@ -44,9 +83,23 @@ class BasicBlock final {
     void push_phys(PhyInitList list);
     size_t removeUnusedInstrs();
     InstrIt erase_instr(InstrIt it);
+    /// @brief O(1) given the instr; id versions scan bb, InstrManager::get finds instr by id
+    InstrIt erase_instr(Instr *instr);
     id_t erase_instr(id_t id);
+    /// @return false if instr still has users or is out of bb
+    bool erase_unused_instr(Instr *instr);
     id_t erase_unused_instr(id_t id);
     std::pair<InstrIt, Instr*> cut_instr(id_t key);
+    /// @brief O(1): take instr out of bb w/o touching its DF
+    /// @return iterator to the next instr
+    InstrIt unlink_instr(Instr *instr);
+    /// @brief O(1): attach instr before/after pos (pos == nullptr: at end/begin)
+    InstrIt insert_before(Instr *pos, Instr *instr);
+    InstrIt insert_after(Instr *pos, Instr *instr);
+    /// @brief move range [first, last] of other before pos; O(range) for bb pointers only
+    void splice(Instr *pos, BasicBlock &other, Instr *first, Instr *last);
+    size_t instr_count() const;
+    size_t phy_count() const;
     PhyIt erase_phy(PhyIt it);
     id_t set_id(id_t id);
     InstrIt instr_begin();
@@ -56,6 +109,10 @@ class BasicBlock final {
     PhyIt phy_end();
     PhyIt phy_last();
 
+    /// @brief instrs order inside bb (phys go first); O(1) after lazy renumbering
+    /// @return true if a is placed before b
+    bool is_before(const InstrBase *a, const InstrBase *b);
+
     void throwIfNotConsistent_() const;
     std::vector<std::string> dump_() const;
     std::string dump() const;
@@ -67,10 +124,19 @@ class BasicBlock final {
     PhyCIt phy_cend() const;
     PhyCIt phy_clast() const;
 
+  private:
+    void renumber_();
+
   private:
     id_t m_bb_id{ID_UNDEF};
-    PhyContainer m_phys{};
-    InstrContainer m_instrs{};
+    // intrusive lists over InstrBase prev/next links
+    Phy *m_phy_first{nullptr};
+    Phy *m_phy_last{nullptr};
+    size_t m_phy_count{0};
+    Instr *m_instr_first{nullptr};
+    Instr *m_instr_last{nullptr};
+    size_t m_instr_count{0};
     id_t m_cur_instr_id{ID_UNDEF};
+    bool m_order_valid{false};
 };
 } // namespace IR
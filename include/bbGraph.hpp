@@ -1,5 +1,6 @@
 #pragma once
 #include "graph.hpp"
+#include "graphBuilder.hpp"
 #include "basicblock.hpp"
 
 namespace IR {
@@ -15,6 +16,8 @@ class BbGraph : public Graph<BasicBlock, int> {
     /// @brief add node with given key; if no key provided - use bb key; if bb key is undefined - use graph keygen and set bb_id = key
     /// @return node key or KEY_UNDEF in case of error
     G::key_t add_node(BasicBlock& node_data, id_t key = G::KEY_UNDEF) override;
+    /// @brief Graph::compact + bb ids & header key follow new node keys
+    G::KeyMapT compact() override;
     std::string dump() const override;
     /// @brief get header basic block; it should contain constant & param nodes
     /// @return node key or KEY_UNDEF if not found
@@ -37,20 +40,41 @@ class BbGraph : public Graph<BasicBlock, int> {
     void removeUnusedConsts() {
         auto &head = accessHeader()->data();
         auto it = head.instr_begin();
-        std::vector<IR::id_t> keys{}; 
         while (it != head.instr_end()) {
-            if ((*it)->type() == IR::GroupType::CONST && (*it)->users().size() == 0) {
-                keys.push_back((*it)->get_id());
+            if ((*it)->type() == IR::GroupType::CONST && (*it)->user_count() == 0) {
+                it = head.erase_instr(it);
+            } else {
+                ++it;
             }
-            ++it;
-        }
-        for (auto key : keys) {
-            head.erase_instr(key);
         }
     }
+    /// @brief instr-level dominance: bb dominance from header + position inside same bb
+    /// @return true if a == b or a is executed before b on every path from header
+    bool instr_dominates(const InstrBase *a, const InstrBase *b);
+    /// @brief dominance frontier of bb from header; cached until the CFG changes
+    std::vector<G::key_t> dom_frontier(G::key_t bb_key);
+    /// @return lowest bb dominating both a & b (from header); KEY_UNDEF if one is unreachable
+    G::key_t nearest_common_dominator(G::key_t a, G::key_t b);
+    /// @brief blocks needing phi for a value defined in def_bbs (iterated frontier)
+    std::vector<G::key_t> phi_blocks(const std::vector<G::key_t> &def_bbs);
+    /// @brief loop queries from header; cached until the CFG changes
+    size_t loop_depth(G::key_t bb_key);
+    /// @return header of innermost loop containing bb; KEY_UNDEF outside of loops
+    G::key_t loop_header(G::key_t bb_key);
+    std::vector<G::key_t> latches(G::key_t loop_header_key);
+    std::vector<G::EdgeEndsT> loop_exits(G::key_t loop_header_key);
+    G::key_t preheader(G::key_t loop_header_key);
+    bool is_irreducible_loop(G::key_t loop_header_key);
     void throwIfNotConsistent();
     private:
     G::key_t m_headerBbKey{G::KEY_UNDEF};
     Metadata m_metadata; 
 };
-} // namespace IR
\ No newline at end of file
+} // namespace IR
+namespace G {
+/// @brief bulk-built BbGraph follows BbGraph::add_node: key defaults to bb id, bb id = node key
+template <> struct BuilderNodeTraits<IR::BasicBlock> {
+    static key_t default_key(const IR::BasicBlock &bb) { return bb.get_id(); }
+    static void set_key(IR::BasicBlock &bb, key_t key) { bb.set_id(key); }
+};
+} // namespace G
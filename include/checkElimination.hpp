@@ -9,7 +9,7 @@ bool dominativeCheckAnalysis(IR::Instr *prev, IR::Instr* cur, IR::BbGraph &g) {
         return false;
     }
     auto it0 = prev->inputs_begin();
-    ASSERT_DEV(cur->inputs().size() == prev->inputs().size(), "Wrong number of inputs");
+    ASSERT_DEV(cur->input_count() == prev->input_count(), "Wrong number of inputs");
     for (auto it = cur->inputs_begin(); it != cur->inputs_end(); ++it) {
         if (*it != *it0) {
             return false;
@@ -17,13 +17,7 @@ bool dominativeCheckAnalysis(IR::Instr *prev, IR::Instr* cur, IR::BbGraph &g) {
         ++it0;
     }
 
-    auto prev_bb_key = prev->bb()->get_id();
-    auto cur_bb_key = cur->bb()->get_id();
-    if (prev_bb_key == cur_bb_key) {
-        return true;
-    }
-
-    return g.is_a_dominates_b(g.accessHeader()->get_key(), prev_bb_key, cur_bb_key);
+    return g.instr_dominates(prev, cur);
 }
 
 
@@ -38,7 +32,7 @@ Check elimination algo:
 */
 void doCheckElimination(IR::BbGraph &g) {
     std::list<IR::Instr *> checks{};
-    auto sequence = g.RPO(g.accessHeader()->get_key());
+    const auto &sequence = g.RPO(g.accessHeader()->get_key());
     for (auto key : sequence) {
         auto &bb = g.at(key)->data();
         for (auto it = bb.instr_begin(); it != bb.instr_end(); ++it) {
@@ -63,8 +57,8 @@ void doCheckElimination(IR::BbGraph &g) {
         if (result) {
             auto *i = *currentCheckIt;
             auto *basicBlock = i->bb();
-            auto result = basicBlock->erase_instr(i->get_id());
-            ASSERT_DEV(result != IR::ID_UNDEF, "Error during instr deletion");
+            ASSERT_DEV(basicBlock, "Error during instr deletion");
+            basicBlock->erase_instr(i);
             currentCheckIt = checks.erase(currentCheckIt);
             prevCheckIt = checks.begin();
         } else {
@@ -6,9 +6,9 @@
 using InstrIt = IR::BasicBlock::InstrIt;
 
 bool calcConstants(IR::Instr *i) {
-    ASSERT_DEV(i->inputs().size() == 2, "Wrong instr inputs");
-    auto input1 = i->inputs().front();
-    auto input2 = i->inputs().back();
+    ASSERT_DEV(i->input_count() == 2, "Wrong instr inputs");
+    auto input1 = i->input(0);
+    auto input2 = i->input(1);
     if (input1->type() == IR::GroupType::PHY || input2->type() == IR::GroupType::PHY) {
         return false;
     }
@@ -47,10 +47,8 @@ bool doConstFoldProp(IR::BbGraph &g) {
         auto instr = *it;
         auto replace = calcConstants(instr);
         if (replace) {
-            auto cut = bb.cut_instr(instr->get_id());
-            ASSERT_DEV(cut.second, "Instr does not exist");
+            it = bb.unlink_instr(instr);
             head->data().push_instrs({instr});
-            it = cut.first;
         } else {
             ++it;
         }
@@ -59,9 +57,9 @@ bool doConstFoldProp(IR::BbGraph &g) {
 }
 
 std::pair<IR::Instr *, IR::Instr *> detachInputsFromArg(IR::Instr *arg) {
-    ASSERT_DEV(arg->inputs().size() == 2, "Wrong count of inputs for this peephole");
-    auto input1 = arg->inputs().front();
-    auto input2 = arg->inputs().back();
+    ASSERT_DEV(arg->input_count() == 2, "Wrong count of inputs for this peephole");
+    auto input1 = arg->input(0);
+    auto input2 = arg->input(1);
     if (input1->type() == IR::GroupType::PHY || input2->type() == IR::GroupType::PHY) {
         return {nullptr, nullptr};
     }
@@ -70,8 +68,7 @@ std::pair<IR::Instr *, IR::Instr *> detachInputsFromArg(IR::Instr *arg) {
     if ((arg1->type() != IR::GroupType::CONST && arg2->type() == IR::GroupType::CONST) ||
         (arg1->type() == IR::GroupType::CONST && arg2->type() != IR::GroupType::CONST)) {
 
-        arg->erase_input(arg1->bb()->get_id(), arg1->get_id());
-        arg->erase_input(arg2->bb()->get_id(), arg2->get_id());
+        arg->drop_inputs();
         if (arg1->type() != IR::GroupType::CONST) {
             return {arg1, arg2};
         }
@@ -88,9 +85,9 @@ id_t makePeepholes(IR::Instr *i, IR::BbGraph &g, IR::InstrManager &mem) {
     if (i->m_opcd != IR::OpcodeType::ADD && i->m_opcd != IR::OpcodeType::XOR) {
         return IR::ID_UNDEF;
     }
-    ASSERT_DEV(i->inputs().size() == 2, "Wrong instr inputs");
-    auto input1 = i->inputs().front();
-    auto input2 = i->inputs().back();
+    ASSERT_DEV(i->input_count() == 2, "Wrong instr inputs");
+    auto input1 = i->input(0);
+    auto input2 = i->input(1);
     if (input1->type() == IR::GroupType::PHY || input2->type() == IR::GroupType::PHY) {
         return IR::ID_UNDEF;
     }
@@ -115,11 +112,8 @@ id_t makePeepholes(IR::Instr *i, IR::BbGraph &g, IR::InstrManager &mem) {
             return IR::ID_UNDEF;
         }
         // now I0, C0 are not inputs for I1
-        // delete I1, C1 as inputs for I2
-        i->erase_input(arg1->bb()->get_id(), arg1->get_id());
-        i->erase_input(arg2->bb()->get_id(), arg2->get_id());
-        // add I0 as input for I2
-        i->push_input(prevArgs.first);
+        // I0 takes place of I1 as input for I2
+        i->setOperand(0, prevArgs.first);
         // create and init new C3 = F(C1,C2)
         auto val{0};
         switch (i->m_opcd) {
@@ -132,8 +126,8 @@ id_t makePeepholes(IR::Instr *i, IR::BbGraph &g, IR::InstrManager &mem) {
         }
         auto *c3 = mem.createCONST(IR::ValueHolder(val, IR::NO_VALUEHOLDER));
         g.accessHeader()->data().push_instrs({c3});
-        // make as I2 input
-        i->push_input(c3);
+        // C3 takes place of C1 as input for I2
+        i->setOperand(1, c3);
         return arg1->get_id();
     }
     return IR::ID_UNDEF;
@@ -146,7 +140,7 @@ bool doPeepholes(IR::BbGraph &g, IR::InstrManager &mem) {
     // first bb - constants and inputs
     auto *head = g.accessHeader();
     ASSERT_DEV(head, "No head detected");
-    auto rpo = g.RPO(head->get_key());
+    const auto &rpo = g.RPO(head->get_key());
     auto keyIt = ++rpo.begin();
     while (keyIt != rpo.end()) {
         auto &bb = g.at(*keyIt)->data();
@@ -163,7 +157,7 @@ bool doPeepholes(IR::BbGraph &g, IR::InstrManager &mem) {
         while(!oddInstrs.empty()) {
             auto id = oddInstrs.back();
             std::cout << "delete " << id << std::endl;
-            bb.erase_unused_instr(id);
+            bb.erase_unused_instr(static_cast<IR::Instr *>(mem.get(id)));
             oddInstrs.pop_back();
         }
         ++keyIt;
@@ -174,7 +168,7 @@ bool doPeepholes(IR::BbGraph &g, IR::InstrManager &mem) {
 
 bool applyPeephole(IR::Instr *i, IR::InstrManager &mem, IR::BasicBlock &head) {
     // XOR a, a --> 0
-    if (i->m_opcd == IR::OpcodeType::XOR && i->inputs().front() == i->inputs().back()) {
+    if (i->m_opcd == IR::OpcodeType::XOR && i->input(0) == i->input(1)) {
         i->m_type = IR::GroupType::CONST;
         i->m_value.m_val =  0;
         i->m_value.m_regNum = IR::NO_VALUEHOLDER;
@@ -182,8 +176,8 @@ bool applyPeephole(IR::Instr *i, IR::InstrManager &mem, IR::BasicBlock &head) {
     }
     // AND a, 0 --> 0
     if (i->m_opcd == IR::OpcodeType::AND) {
-        auto *arg1 = i->inputs().front();
-        auto *arg2 = i->inputs().back();
+        auto *arg1 = i->input(0);
+        auto *arg2 = i->input(1);
         if (arg1->type() == IR::GroupType::CONST) {
             auto *arg = static_cast<IR::Instr*>(arg1);
             if (arg->m_value.m_val == 0) {
@@ -203,13 +197,10 @@ bool applyPeephole(IR::Instr *i, IR::InstrManager &mem, IR::BasicBlock &head) {
         }
     }
     // add a, a --> shl a, 1
-    if (i->m_opcd == IR::OpcodeType::ADD && i->inputs().front() == i->inputs().back()) {
+    if (i->m_opcd == IR::OpcodeType::ADD && i->input(0) == i->input(1)) {
         i->m_opcd = IR::OpcodeType::SHL;
-        auto *arg = i->inputs().front();
-        i->inputs().remove(arg);
-        i->inputs().push_back(arg);
         auto *cnst = mem.createCONST({1, IR::NO_VALUEHOLDER});
-        i->push_input(cnst);
+        i->setOperand(1, cnst);
         head.push_instrs({cnst});
         return false; // do not move to head as const
     }
@@ -224,7 +215,7 @@ void doAtomicPeepholes(IR::BbGraph &g, IR::InstrManager &mem) {
     // first bb - constants and inputs
     auto *head = g.accessHeader();
     ASSERT_DEV(head, "No head detected");
-    auto rpo = g.RPO(head->get_key());
+    const auto &rpo = g.RPO(head->get_key());
     auto keyIt = ++rpo.begin();
     while (keyIt != rpo.end()) {
         auto &bb = g.at(*keyIt)->data();
@@ -232,9 +223,8 @@ void doAtomicPeepholes(IR::BbGraph &g, IR::InstrManager &mem) {
         while (it != bb.instr_end()) {
             auto instr = *it;
             if (applyPeephole(instr, mem, head->data())) {
-                auto itAndInstr = bb.cut_instr(instr->get_id());
-                head->data().push_instrs({itAndInstr.second});
-                it = itAndInstr.first;
+                it = bb.unlink_instr(instr);
+                head->data().push_instrs({instr});
             } else {
                 ++it;
             }
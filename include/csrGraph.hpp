@@ -0,0 +1,141 @@
+#pragma once
+#include "config.hpp"
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace G {
+using key_t = long long;
+constexpr key_t KEY_UNDEF = 0;
+// dense node index used by analyses (0..n-1)
+using idx_t = uint32_t;
+constexpr idx_t IDX_UNDEF = std::numeric_limits<idx_t>::max();
+
+/// @brief no-op hooks for CsrGraph::DFS_visit; derive and hide the ones needed
+struct CsrVisitor {
+    /// @return false to stop the whole traversal
+    bool pre(idx_t) { return true; }
+    void post(idx_t) {}
+    /// @brief edge to a node that is still on the DFS stack
+    void back_edge(idx_t, idx_t) {}
+};
+
+/// @brief frozen compressed-sparse-row view of a graph for read-only analyses
+/// nodes are numbered densely in the order of keys given to build
+class CsrGraph {
+  public:
+    struct EdgeT {
+        key_t start;
+        key_t end;
+        key_t key;
+    };
+
+    CsrGraph() = default;
+
+    /// @brief edges keep their relative order inside successor/predecessor ranges
+    void build(const std::vector<key_t> &node_keys, const std::vector<EdgeT> &edges);
+    /// @brief reversed g with a virtual exit at index g.size() (key KEY_UNDEF) whose successors
+    /// are the nodes w/o successors in g; node indices are shared with g, edge keys are dropped
+    void reverse(const CsrGraph &g);
+    void clear();
+
+    size_t size() const;
+    size_t edge_count() const;
+    /// @return IDX_UNDEF for unknown key
+    idx_t index(key_t key) const;
+    /// @return KEY_UNDEF for wrong index
+    key_t key(idx_t node) const;
+
+    const idx_t *successors_begin(idx_t node) const;
+    const idx_t *successors_end(idx_t node) const;
+    /// @brief edge keys, parallel to the successor range
+    const key_t *out_edges_begin(idx_t node) const;
+    const idx_t *predecessors_begin(idx_t node) const;
+    const idx_t *predecessors_end(idx_t node) const;
+    size_t get_successor_count(idx_t node) const;
+    size_t get_predecessor_count(idx_t node) const;
+    template <typename F> void for_each_successor(idx_t node, F f) const;
+    template <typename F> void for_each_predecessor(idx_t node, F f) const;
+
+    /// @brief iterative DFS from root; a visitor must not start another traversal of this view
+    template <typename VisitorT> void DFS_visit(idx_t root, VisitorT &visitor) const;
+    /// @brief preorder is written into caller's buffer (cleared first)
+    void DFS(idx_t root, std::vector<idx_t> &preorder, idx_t end = IDX_UNDEF) const;
+    /// @brief reverse DFS post-order into caller's buffer (cleared first)
+    void RPO(idx_t root, std::vector<idx_t> &rpo) const;
+    bool hasPath(idx_t start, idx_t end) const;
+    /// @brief (start, end) of DFS back edges into caller's buffer (cleared first)
+    void back_edges(idx_t root, std::vector<std::pair<idx_t, idx_t>> &edges) const;
+    /// @brief strongly connected components of the whole view (iterative Tarjan); ids are
+    /// given in reverse topological order of the condensation: sink components come first
+    /// @return number of components
+    idx_t SCC(std::vector<idx_t> &component) const;
+
+  private:
+    std::vector<key_t> m_keys{};
+    std::unordered_map<key_t, idx_t> m_index{};
+    // successors of i are m_succs[m_succ_begin[i]..m_succ_begin[i + 1])
+    std::vector<idx_t> m_succ_begin{};
+    std::vector<idx_t> m_succs{};
+    std::vector<key_t> m_succ_edges{};
+    std::vector<idx_t> m_pred_begin{};
+    std::vector<idx_t> m_preds{};
+
+    // traversal scratch: epoch stamps & reusable stack
+    mutable size_t m_visit_epoch{0};
+    mutable std::vector<size_t> m_enter_mark{};
+    mutable std::vector<size_t> m_exit_mark{};
+    mutable std::vector<std::pair<idx_t, const idx_t *>> m_dfs_stack{};
+};
+
+template <typename F> void CsrGraph::for_each_successor(idx_t node, F f) const {
+    for (auto *it = successors_begin(node); it != successors_end(node); ++it) {
+        f(*it);
+    }
+}
+
+template <typename F> void CsrGraph::for_each_predecessor(idx_t node, F f) const {
+    for (auto *it = predecessors_begin(node); it != predecessors_end(node); ++it) {
+        f(*it);
+    }
+}
+
+template <typename VisitorT> void CsrGraph::DFS_visit(idx_t root, VisitorT &visitor) const {
+    if (root >= size()) {
+        OPT(LOG("No such node index"));
+        return;
+    }
+    const size_t epoch = ++m_visit_epoch;
+    auto &stack = m_dfs_stack;
+    stack.clear();
+    auto enter = [this, epoch, &stack, &visitor](idx_t node) {
+        m_enter_mark[node] = epoch;
+        if (!visitor.pre(node)) {
+            return false;
+        }
+        stack.emplace_back(node, successors_begin(node));
+        return true;
+    };
+    bool proceed = enter(root);
+    while (proceed && !stack.empty()) {
+        auto &top = stack.back();
+        idx_t node = top.first;
+        if (top.second == successors_end(node)) {
+            m_exit_mark[node] = epoch;
+            visitor.post(node);
+            stack.pop_back();
+            continue;
+        }
+        idx_t succ = *top.second++;
+        if (m_enter_mark[succ] != epoch) {
+            proceed = enter(succ);
+        } else if (m_exit_mark[succ] != epoch) {
+            visitor.back_edge(node, succ);
+        }
+    }
+    stack.clear();
+}
+
+} // namespace G
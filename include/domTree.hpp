@@ -0,0 +1,287 @@
+#pragma once
+#include "config.hpp"
+#include "csrGraph.hpp"
+#include <algorithm>
+#include <vector>
+
+namespace G {
+
+/// @brief dominator tree over densely indexed nodes
+/// built by SEMI-NCA: Lengauer-Tarjan semidominators + NCA walk for idoms
+/// GraphT for incremental updates provides size(), for_each_successor(node, f) and
+/// for_each_predecessor(node, f) over the same indices, see CsrGraph
+class DomTree {
+  public:
+    /// @brief in-place updates w/o a query in between; each one after the first renumbers the
+    /// whole tree, so past this many the owner should rebuild on the next query instead
+    static constexpr size_t PENDING_LIMIT = 8;
+
+    DomTree() = default;
+
+    /// @brief compute idom for every node reachable from root
+    void build(idx_t root, const CsrGraph &g);
+    /// @brief update after edge from->to was added to g (g already has it); only nodes whose
+    /// idom moves up to NCA(from, to) are visited (depth-based search)
+    /// @return false if new nodes became reachable - tree is stale, rebuild it
+    template <typename GraphT> bool insert_edge(const GraphT &g, idx_t from, idx_t to);
+    /// @brief update after edge from->to was removed from g; SEMI-NCA is rerun on the subtree
+    /// of NCA(from, to) only
+    /// @return false if some nodes became unreachable - tree is stale, rebuild it
+    template <typename GraphT> bool delete_edge(const GraphT &g, idx_t from, idx_t to);
+    void clear();
+    /// @brief updates since the last query; depth, children & DFS numbers are derived lazily
+    size_t pending() const;
+    /// @brief in-place updates applied since build
+    size_t updates() const;
+
+    idx_t root() const;
+    size_t size() const;
+    bool reachable(idx_t node) const;
+    /// @return immediate dominator; IDX_UNDEF for root and unreachable nodes
+    idx_t idom(idx_t node) const;
+    /// @return depth in dominator tree (root has depth 0)
+    idx_t depth(idx_t node) const;
+    /// @return nearest common dominator; IDX_UNDEF if a or b is unreachable
+    idx_t nca(idx_t a, idx_t b) const;
+    /// @brief O(1) check via dominator tree DFS entry/exit numbers
+    bool dominates(idx_t a, idx_t b) const;
+    bool strictly_dominates(idx_t a, idx_t b) const;
+    /// @return dominator tree DFS entry/exit numbers; IDX_UNDEF for unreachable nodes
+    idx_t dfs_in(idx_t node) const;
+    idx_t dfs_out(idx_t node) const;
+    /// @brief dominator tree children of node
+    const idx_t *children_begin(idx_t node) const;
+    const idx_t *children_end(idx_t node) const;
+    /// @brief reachable nodes in dominator tree preorder
+    const std::vector<idx_t> &preorder() const;
+
+  private:
+    // sets idom of nodes reachable from root through nodes accepted by descend; idom of root
+    // itself is kept
+    template <typename GraphT, typename DescendT>
+    void semi_nca_(const GraphT &g, idx_t root, DescendT descend);
+    // depth, children ranges, preorder & DFS numbers from m_idom
+    void number_() const;
+    // queries: end the run of pending updates, number_ if the tree changed since
+    void renumber_() const;
+    // updates use these w/o renumber_, numbering must be up to date
+    bool reachable_(idx_t node) const;
+    idx_t nca_(idx_t a, idx_t b) const;
+    bool dominates_(idx_t a, idx_t b) const;
+
+  private:
+    idx_t m_root{IDX_UNDEF};
+    std::vector<idx_t> m_idom{};
+    // derived from m_idom, lazily after in-place updates
+    mutable std::vector<idx_t> m_depth{};
+    mutable std::vector<idx_t> m_preorder{};
+    mutable std::vector<idx_t> m_dfs_in{};
+    mutable std::vector<idx_t> m_dfs_out{};
+    // dominator tree as children ranges: children of i are m_children[m_child_begin[i]..[i+1])
+    mutable std::vector<idx_t> m_child_begin{};
+    mutable std::vector<idx_t> m_children{};
+    mutable bool m_dirty{false};
+    mutable size_t m_pending{0};
+    size_t m_updates{0};
+
+    // update scratch: preorder numbers within the current semi_nca_ run, IDX_UNDEF otherwise
+    std::vector<idx_t> m_num{};
+};
+
+template <typename GraphT, typename DescendT>
+void DomTree::semi_nca_(const GraphT &g, idx_t root, DescendT descend) {
+    // iterative DFS: preorder numbers & DFS tree parents (in numbers)
+    std::vector<idx_t> order{};
+    std::vector<idx_t> parent{};
+    std::vector<std::pair<idx_t, idx_t>> stack{{root, IDX_UNDEF}};
+    while (!stack.empty()) {
+        auto [node, from] = stack.back();
+        stack.pop_back();
+        if (m_num[node] != IDX_UNDEF) {
+            continue;
+        }
+        idx_t w = static_cast<idx_t>(order.size());
+        m_num[node] = w;
+        order.push_back(node);
+        parent.push_back(from);
+        size_t mark = stack.size();
+        g.for_each_successor(node, [&](idx_t succ) {
+            if (m_num[succ] == IDX_UNDEF && descend(succ)) {
+                stack.emplace_back(succ, w);
+            }
+        });
+        // first successor is visited first
+        std::reverse(stack.begin() + mark, stack.end());
+    }
+
+    // semidominators in preorder numbers, linking in reverse preorder
+    const idx_t count = static_cast<idx_t>(order.size());
+    std::vector<idx_t> semi(count);
+    std::vector<idx_t> label(count);
+    std::vector<idx_t> ancestor(count, IDX_UNDEF);
+    std::vector<idx_t> path{};
+    for (idx_t i = 0; i < count; ++i) {
+        semi[i] = i;
+        label[i] = i;
+    }
+    auto eval = [&](idx_t v) {
+        if (ancestor[v] == IDX_UNDEF) {
+            return v;
+        }
+        // iterative path compression
+        idx_t x = v;
+        while (ancestor[ancestor[x]] != IDX_UNDEF) {
+            path.push_back(x);
+            x = ancestor[x];
+        }
+        while (!path.empty()) {
+            idx_t y = path.back();
+            path.pop_back();
+            idx_t a = ancestor[y];
+            if (semi[label[a]] < semi[label[y]]) {
+                label[y] = label[a];
+            }
+            ancestor[y] = ancestor[a];
+        }
+        return label[v];
+    };
+    for (idx_t w = count - 1; w > 0; --w) {
+        g.for_each_predecessor(order[w], [&](idx_t pred) {
+            idx_t v = m_num[pred];
+            if (v == IDX_UNDEF) {
+                return; // unreachable or outside of the subtree being rebuilt
+            }
+            idx_t candidate = semi[eval(v)];
+            if (candidate < semi[w]) {
+                semi[w] = candidate;
+            }
+        });
+        ancestor[w] = parent[w];
+    }
+
+    // idom(w) = NCA(parent(w), sdom(w)) in the partially built tree
+    std::vector<idx_t> idom(parent);
+    for (idx_t w = 1; w < count; ++w) {
+        while (idom[w] > semi[w]) {
+            idom[w] = idom[idom[w]];
+        }
+        m_idom[order[w]] = order[idom[w]];
+    }
+    for (idx_t node : order) {
+        m_num[node] = IDX_UNDEF;
+    }
+}
+
+template <typename GraphT> bool DomTree::insert_edge(const GraphT &g, idx_t from, idx_t to) {
+    if (m_dirty) {
+        number_();
+    }
+    ++m_pending;
+    ++m_updates;
+    if (!reachable_(from)) {
+        return true;
+    }
+    if (!reachable_(to)) {
+        return false;
+    }
+    const idx_t top = nca_(from, to);
+    const idx_t top_depth = m_depth[top];
+    if (m_depth[to] <= top_depth + 1) {
+        return true;
+    }
+    // affected nodes get idom = top: they are reachable from `to` through nodes not shallower
+    // than themselves; visit them deepest first, m_num marks visited nodes
+    std::vector<idx_t> affected{};
+    std::vector<idx_t> visited{to};
+    std::vector<std::pair<idx_t, idx_t>> bucket{{m_depth[to], to}};
+    std::vector<idx_t> stack{};
+    m_num[to] = 0;
+    while (!bucket.empty()) {
+        std::pop_heap(bucket.begin(), bucket.end());
+        const idx_t level = bucket.back().first;
+        stack.push_back(bucket.back().second);
+        bucket.pop_back();
+        affected.push_back(stack.back());
+        while (!stack.empty()) {
+            idx_t node = stack.back();
+            stack.pop_back();
+            g.for_each_successor(node, [&](idx_t succ) {
+                idx_t succ_depth = m_depth[succ];
+                if (succ_depth <= top_depth + 1 || m_num[succ] != IDX_UNDEF) {
+                    return;
+                }
+                m_num[succ] = 0;
+                visited.push_back(succ);
+                if (succ_depth > level) {
+                    stack.push_back(succ);
+                } else {
+                    bucket.emplace_back(succ_depth, succ);
+                    std::push_heap(bucket.begin(), bucket.end());
+                }
+            });
+        }
+    }
+    for (idx_t node : visited) {
+        m_num[node] = IDX_UNDEF;
+    }
+    for (idx_t node : affected) {
+        m_idom[node] = top;
+    }
+    m_dirty = true;
+    return true;
+}
+
+template <typename GraphT> bool DomTree::delete_edge(const GraphT &g, idx_t from, idx_t to) {
+    if (m_dirty) {
+        number_();
+    }
+    ++m_pending;
+    ++m_updates;
+    if (!reachable_(from) || !reachable_(to)) {
+        return true;
+    }
+    const idx_t top = nca_(from, to);
+    if (top == to) {
+        return true; // to dominates from, no path to anything went through the edge
+    }
+    // to stays reachable iff some other predecessor can be reached avoiding it
+    bool supported = false;
+    g.for_each_predecessor(to, [&](idx_t pred) {
+        supported = supported || (reachable_(pred) && !dominates_(to, pred));
+    });
+    if (!supported) {
+        return false;
+    }
+    // edges leaving subtree of top go to nodes not deeper than top, so depth bounds the DFS
+    const idx_t top_depth = m_depth[top];
+    semi_nca_(g, top, [this, top_depth](idx_t node) {
+        return m_depth[node] != IDX_UNDEF && m_depth[node] > top_depth;
+    });
+    m_dirty = true;
+    return true;
+}
+
+/// @brief dominance frontiers over the same dense indices as DomTree
+/// built by the Cooper/Harvey/Kennedy runner walk from join nodes
+class DomFrontier {
+  public:
+    DomFrontier() = default;
+
+    void build(const DomTree &tree, const CsrGraph &g);
+    void clear();
+
+    size_t size() const;
+    /// @brief frontier of node; empty range for unreachable nodes
+    const idx_t *frontier_begin(idx_t node) const;
+    const idx_t *frontier_end(idx_t node) const;
+    size_t get_frontier_size(idx_t node) const;
+    /// @brief iterated frontier DF+(defs), i.e. phi placement points; result is sorted
+    void iterated(const std::vector<idx_t> &defs, std::vector<idx_t> &result) const;
+
+  private:
+    // frontier of i is m_frontier[m_begin[i]..m_begin[i + 1])
+    std::vector<idx_t> m_begin{};
+    std::vector<idx_t> m_frontier{};
+};
+
+} // namespace G
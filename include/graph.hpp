@@ -1,5 +1,12 @@
 #pragma once
 #include "config.hpp"
+#include "csrGraph.hpp"
+#include "domTree.hpp"
+#include "lcaIndex.hpp"
+#include "loopForest.hpp"
+#include "reachability.hpp"
+#include "smallVector.hpp"
+#include <algorithm>
 #include <exception>
 #include <list>
 #include <map>
@@ -8,10 +15,9 @@
 #include <set>
 #include <sstream>
 #include <string>
+#include <unordered_map>
 #include <vector>
 namespace G {
-using key_t = long long;
-constexpr key_t KEY_UNDEF = 0;
 constexpr key_t KEY_DUBLICATE = -1;
 
 enum class ColorT {
@@ -34,11 +40,30 @@ struct Cycle {
 
 using weight_t = int;
 
+// old key -> new key
+using KeyMapT = std::unordered_map<key_t, key_t>;
+
+// (start node key, end node key)
+using EdgeEndsT = std::pair<key_t, key_t>;
+struct EdgeEndsHash {
+    size_t operator()(const EdgeEndsT &ends) const {
+        size_t h = std::hash<key_t>{}(ends.first);
+        return h ^ (std::hash<key_t>{}(ends.second) + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2));
+    }
+};
+
 template <typename N, typename E> class Graph;
+template <typename N, typename E> class GraphBuilder;
 
 // N - type of additional data
 template <typename N, typename E> class Node {
 
+  public:
+    // neighbours sorted by key; most CFG nodes fit inline
+    using AdjacencyT = SmallVector<std::pair<key_t, Node<N, E> *>, 4>;
+    using AdjacencyIt = typename AdjacencyT::iterator;
+    using EdgeListT = SmallVector<key_t, 4>;
+
   public:
     Node(N &data, const Graph<N, E> &g);
     virtual ~Node(){};
@@ -46,11 +71,18 @@ template <typename N, typename E> class Node {
     key_t add_predecessor(key_t p_key);
     key_t delete_successor(key_t s_key);
     key_t delete_predecessor(key_t p_key);
-
-    typename std::map<key_t, Node<N, E> *>::iterator predecessors_begin();
-    typename std::map<key_t, Node<N, E> *>::iterator predecessors_end();
-    typename std::map<key_t, Node<N, E> *>::iterator successors_begin();
-    typename std::map<key_t, Node<N, E> *>::iterator successors_end();
+    // incident edges bookkeeping (edge keys)
+    void add_out_edge(key_t edge_key);
+    void add_in_edge(key_t edge_key);
+    key_t delete_out_edge(key_t edge_key);
+    key_t delete_in_edge(key_t edge_key);
+    const EdgeListT &out_edges() const;
+    const EdgeListT &in_edges() const;
+
+    AdjacencyIt predecessors_begin();
+    AdjacencyIt predecessors_end();
+    AdjacencyIt successors_begin();
+    AdjacencyIt successors_end();
 
     void set_color(ColorT c);
     void set_loop(key_t header_key);
@@ -60,21 +92,34 @@ template <typename N, typename E> class Node {
     key_t get_loop() const;
     size_t get_predecessor_count() const;
     size_t get_successor_count() const;
+    // traversal stamps: entered / finished during traversal with this epoch
+    size_t get_enter_mark() const;
+    size_t get_exit_mark() const;
+    void set_enter_mark(size_t epoch);
+    void set_exit_mark(size_t epoch);
     key_t key_init();
     key_t set_key(key_t key);
     // const weight_t get_weight() const;
   protected:
+    // first neighbour with key not less than given one
+    static AdjacencyIt find_neighbour_(AdjacencyT &adj, key_t key);
     // const Node<N, E> *get_node_ptr(key_t node_key);
     // friend const Node<N,E> *Graph<N,E>::get_node_ptr(key_t node_key);
+    friend class Graph<N, E>;
+    friend class GraphBuilder<N, E>;
     N &m_data;
 
   protected:
     const Graph<N, E> *m_graph{nullptr};
     key_t m_key{KEY_UNDEF};
-    std::map<key_t, Node<N, E> *> m_successors{};
-    std::map<key_t, Node<N, E> *> m_predecessors{};
+    AdjacencyT m_successors{};
+    AdjacencyT m_predecessors{};
+    EdgeListT m_out_edges{};
+    EdgeListT m_in_edges{};
     ColorT m_color{ColorT::WHITE};
     key_t m_loop{KEY_UNDEF};
+    size_t m_enter_mark{0};
+    size_t m_exit_mark{0};
 };
 
 template <typename N, typename E>
@@ -89,6 +134,14 @@ template <typename N, typename E> key_t Node<N, E>::set_key(key_t key) {
 
 template <typename N, typename E> ColorT Node<N, E>::get_color() const { return m_color; }
 template <typename N, typename E> key_t Node<N, E>::get_loop() const { return m_loop; }
+template <typename N, typename E> size_t Node<N, E>::get_enter_mark() const { return m_enter_mark; }
+template <typename N, typename E> size_t Node<N, E>::get_exit_mark() const { return m_exit_mark; }
+template <typename N, typename E> void Node<N, E>::set_enter_mark(size_t epoch) {
+    m_enter_mark = epoch;
+}
+template <typename N, typename E> void Node<N, E>::set_exit_mark(size_t epoch) {
+    m_exit_mark = epoch;
+}
 
 template <typename N, typename E> size_t Node<N, E>::get_successor_count() const {
     return m_successors.size();
@@ -98,25 +151,31 @@ template <typename N, typename E> size_t Node<N, E>::get_predecessor_count() con
 }
 
 template <typename N, typename E>
-typename std::map<key_t, Node<N, E> *>::iterator Node<N, E>::predecessors_begin() {
+typename Node<N, E>::AdjacencyIt Node<N, E>::predecessors_begin() {
     return m_predecessors.begin();
 }
 
 template <typename N, typename E>
-typename std::map<key_t, Node<N, E> *>::iterator Node<N, E>::predecessors_end() {
+typename Node<N, E>::AdjacencyIt Node<N, E>::predecessors_end() {
     return m_predecessors.end();
 }
 
 template <typename N, typename E>
-typename std::map<key_t, Node<N, E> *>::iterator Node<N, E>::successors_begin() {
+typename Node<N, E>::AdjacencyIt Node<N, E>::successors_begin() {
     return m_successors.begin();
 }
 
 template <typename N, typename E>
-typename std::map<key_t, Node<N, E> *>::iterator Node<N, E>::successors_end() {
+typename Node<N, E>::AdjacencyIt Node<N, E>::successors_end() {
     return m_successors.end();
 }
 
+template <typename N, typename E>
+typename Node<N, E>::AdjacencyIt Node<N, E>::find_neighbour_(AdjacencyT &adj, key_t key) {
+    return std::lower_bound(adj.begin(), adj.end(), key,
+                            [](const auto &item, key_t k) { return item.first < k; });
+}
+
 template <typename N, typename E> key_t Node<N, E>::key_init() {
     if (m_key != KEY_UNDEF) {
         OPT(LOG("Node has already been inited"));
@@ -138,10 +197,12 @@ template <typename N, typename E> key_t Node<N, E>::add_successor(key_t s_key) {
         OPT(LOG("Successor search returns NULL"));
         return KEY_UNDEF;
     }
-    if (!m_successors.insert(std::make_pair(s_key, const_cast<Node<N, E> *>(nptr))).second) {
+    auto pos = find_neighbour_(m_successors, s_key);
+    if (pos != m_successors.end() && pos->first == s_key) {
         OPT(LOG("Successor has already existed"));
         return KEY_DUBLICATE;
     }
+    m_successors.insert(pos, std::make_pair(s_key, const_cast<Node<N, E> *>(nptr)));
     return s_key;
 }
 
@@ -156,33 +217,77 @@ template <typename N, typename E> key_t Node<N, E>::add_predecessor(key_t p_key)
         OPT(LOG("Predecessor search returns NULL"));
         return KEY_UNDEF;
     }
-    if (!m_predecessors.insert(std::make_pair(p_key, const_cast<Node<N, E> *>(nptr))).second) {
+    auto pos = find_neighbour_(m_predecessors, p_key);
+    if (pos != m_predecessors.end() && pos->first == p_key) {
         OPT(LOG("Predecessor has already existed"));
         return KEY_DUBLICATE;
     }
+    m_predecessors.insert(pos, std::make_pair(p_key, const_cast<Node<N, E> *>(nptr)));
     return p_key;
 }
 
 template <typename N, typename E> key_t Node<N, E>::delete_successor(key_t s_key) {
-    auto find_result = m_successors.find(s_key);
-    if (find_result == m_successors.end()) {
+    auto find_result = find_neighbour_(m_successors, s_key);
+    if (find_result == m_successors.end() || find_result->first != s_key) {
         OPT(LOG("Wrong successor key"));
         return KEY_UNDEF;
     }
-    m_successors.erase(s_key);
+    m_successors.erase(find_result);
     return s_key;
 }
 
 template <typename N, typename E> key_t Node<N, E>::delete_predecessor(key_t p_key) {
-    auto find_result = m_predecessors.find(p_key);
-    if (find_result == m_predecessors.end()) {
+    auto find_result = find_neighbour_(m_predecessors, p_key);
+    if (find_result == m_predecessors.end() || find_result->first != p_key) {
         OPT(LOG("Wrong predecessor key"));
         return KEY_UNDEF;
     }
-    m_predecessors.erase(p_key);
+    m_predecessors.erase(find_result);
     return p_key;
 }
 
+template <typename N, typename E> void Node<N, E>::add_out_edge(key_t edge_key) {
+    m_out_edges.push_back(edge_key);
+}
+
+template <typename N, typename E> void Node<N, E>::add_in_edge(key_t edge_key) {
+    m_in_edges.push_back(edge_key);
+}
+
+template <typename N, typename E> key_t Node<N, E>::delete_out_edge(key_t edge_key) {
+    for (auto &key : m_out_edges) {
+        if (key == edge_key) {
+            key = m_out_edges.back();
+            m_out_edges.pop_back();
+            return edge_key;
+        }
+    }
+    OPT(LOG("Wrong out edge key"));
+    return KEY_UNDEF;
+}
+
+template <typename N, typename E> key_t Node<N, E>::delete_in_edge(key_t edge_key) {
+    for (auto &key : m_in_edges) {
+        if (key == edge_key) {
+            key = m_in_edges.back();
+            m_in_edges.pop_back();
+            return edge_key;
+        }
+    }
+    OPT(LOG("Wrong in edge key"));
+    return KEY_UNDEF;
+}
+
+template <typename N, typename E>
+const typename Node<N, E>::EdgeListT &Node<N, E>::out_edges() const {
+    return m_out_edges;
+}
+
+template <typename N, typename E>
+const typename Node<N, E>::EdgeListT &Node<N, E>::in_edges() const {
+    return m_in_edges;
+}
+
 template <typename N, typename E> const key_t Node<N, E>::get_key() const { return m_key; }
 
 template <typename N, typename E> N &Node<N, E>::data() & { return m_data; }
@@ -206,6 +311,8 @@ template <typename N, typename E> class Edge {
     key_t m_start_node_key{KEY_UNDEF};
     key_t m_end_node_key{KEY_UNDEF};
     const Graph<N, E> *m_graph{nullptr};
+
+    friend class Graph<N, E>;
 };
 
 template <typename N, typename E>
@@ -233,6 +340,17 @@ template <typename N, typename E> key_t Edge<N, E>::get_end_node_key() const {
 
 template <typename N, typename E> key_t Edge<N, E>::get_key() const { return m_key; }
 
+/// @brief no-op hooks for Graph::DFS_visit; derive and hide the ones needed
+template <typename N, typename E> struct DfsVisitor {
+    /// @brief node is discovered
+    /// @return false to stop the whole traversal
+    bool pre(Node<N, E> &) { return true; }
+    /// @brief all successors of node are done
+    void post(Node<N, E> &) {}
+    /// @brief edge to a node that is still on the DFS stack
+    void back_edge(Node<N, E> &, Node<N, E> &) {}
+};
+
 template <typename N, typename E> class Graph {
   public:
     Graph() = default;
@@ -253,48 +371,186 @@ template <typename N, typename E> class Graph {
     virtual key_t cut_node(key_t node_key);
     virtual key_t cut_edge(key_t start_node_key, key_t end_node_key);
     virtual key_t paste_all();
+    /// @brief renumber nodes & edges to dense 1..N ranges keeping their relative order;
+    /// node loop tags follow. Not allowed while cut nodes/edges are buffered
+    /// @return old -> new node keys; empty in case of error
+    virtual KeyMapT compact();
     virtual typename std::map<key_t, Node<N, E> *>::iterator nodes_begin();
     virtual typename std::map<key_t, Node<N, E> *>::iterator nodes_end();
 
     Node<N, E> *at(key_t node_key);
 
+    /// @brief iterative DFS from root; visited nodes are stamped with a fresh epoch, colors are
+    /// not touched. A visitor must not start another traversal of this graph
+    template <typename VisitorT> void DFS_visit(key_t root_key, VisitorT &visitor);
     std::vector<key_t> DFS(key_t root_key, key_t end_key = KEY_UNDEF);
+    /// @brief same as DFS but preorder is written into caller's buffer (cleared first)
+    void DFS(key_t root_key, std::vector<key_t> &preorder, key_t end_key = KEY_UNDEF);
     bool hasPath(key_t start, key_t end);
-    std::vector<key_t> RPO(key_t root_key);
+    /// @brief reachability index for batches of path queries; cached until the graph changes
+    const Reachability &reachability();
+    /// @brief same as hasPath but answered by reachability index
+    bool reachable(key_t start, key_t end);
+    /// @brief snapshot of nodes & edges as a CSR view; nodes are indexed in key order
+    void freeze(CsrGraph &view) const;
+    CsrGraph freeze() const;
+    /// @brief reverse DFS post-order from root; cached until the graph changes
+    const std::vector<key_t> &RPO(key_t root_key);
+    /// @brief dominator tree rooted at root_key; cached until nodes change, add_edge/delete_edge
+    /// update a cached tree in place
+    const DomTree &dom_tree(key_t root_key);
+    /// @return immediate dominator key; KEY_UNDEF for root & unreachable nodes
+    key_t get_idom(key_t root_key, key_t node_key);
+    /// @brief dominance frontiers over dom_tree indices; cached until the graph changes
+    const DomFrontier &dom_frontier(key_t root_key);
+    /// @return dominance frontier of node; empty for unreachable nodes
+    std::vector<key_t> get_dom_frontier(key_t root_key, key_t node_key);
+    /// @return iterated dominance frontier of defs (phi placement points) in key order
+    std::vector<key_t> get_iterated_dom_frontier(key_t root_key, const std::vector<key_t> &defs);
     std::vector<key_t> getDominatedNodes(key_t root_key, key_t target_node);
     bool is_a_dominates_b(key_t root_key, key_t a, key_t b);
+    /// @brief LCA index over dom_tree(root_key) indices; cached until the graph changes
+    const LcaIndex &dom_lca(key_t root_key);
+    /// @return lowest node dominating both a & b in O(1); KEY_UNDEF if one is unreachable
+    key_t get_nearest_common_dominator(key_t root_key, key_t a, key_t b);
+    /// @brief graph taken as a tree rooted at root_key (DFS tree parents), e.g. loop tree of
+    /// Analysis::buildLoopTree; cached until the graph changes
+    /// @return lowest common ancestor in O(1); KEY_UNDEF if a or b is not reachable from root
+    key_t get_tree_lca(key_t root_key, key_t a, key_t b);
     std::vector<Cycle> get_cycles(key_t root_key, key_t end_key);
+    /// @brief strongly connected components over a frozen view (iterative Tarjan)
+    /// @return node key -> component id; ids are 1..count, sink components come first
+    KeyMapT get_scc() const;
+    /// @brief condensed DAG of scc: node per component keyed by its id w/ member keys as data,
+    /// edges between different components. Nodes of dag refer to members (cleared first)
+    void condense(const KeyMapT &scc, Graph<std::vector<key_t>, int> &dag,
+                  std::vector<std::vector<key_t>> &members) const;
+    /// @brief post-dominator tree over reversed CSR view rooted at a virtual exit (index
+    /// get_node_count(), successors are all nodes w/o successors); cached until the graph changes
+    const DomTree &post_dom_tree();
+    /// @return immediate post-dominator key; KEY_UNDEF if it is the virtual exit or node cannot
+    /// reach any exit
+    key_t get_ipdom(key_t node_key);
+    bool is_a_postdominates_b(key_t a, key_t b);
+    /// @brief control dependences as frontiers of the post-dominator tree: frontier of node
+    /// lists the branch nodes deciding whether node executes
+    const DomFrontier &control_dependence();
+    /// @return branch nodes that node is control dependent on
+    std::vector<key_t> get_control_dependences(key_t node_key);
+    /// @brief loop forest & per-loop queries from root; cached until the graph changes
+    const LoopInfo &loop_info(key_t root_key);
+    /// @return number of loops containing node; 0 outside of loops
+    size_t get_loop_depth(key_t root_key, key_t node_key);
+    /// @return header key of innermost loop containing node; KEY_UNDEF outside of loops
+    key_t get_loop_header(key_t root_key, key_t node_key);
+    /// @return loop nodes w/ back edge to header
+    std::vector<key_t> get_latches(key_t root_key, key_t header_key);
+    /// @return (inside, outside) node keys of edges leaving loop of header
+    std::vector<EdgeEndsT> get_loop_exits(key_t root_key, key_t header_key);
+    /// @return preheader key; KEY_UNDEF if loop has none
+    key_t get_preheader(key_t root_key, key_t header_key);
+    /// @return true if loop of header can be entered not only through header
+    bool is_loop_irreducible(key_t root_key, key_t header_key);
 
     bool node_exists(key_t key) const;
     virtual std::string dump() const;
     key_t get_avail_nd_key() const;
     key_t get_avail_edg_key() const;
     size_t get_node_count() const;
+    /// @brief bumped by every node/edge modification
+    size_t get_mod_count() const;
     key_t get_edge_id(key_t start_node_key, key_t end_node_key) const;
 
     friend key_t Node<N, E>::add_predecessor(key_t p_key);
     friend key_t Node<N, E>::add_successor(key_t s_key);
 
   protected:
-    // only deletes edge
+    // by edge key; unlinks successor/predecessor & incident lists
     key_t delete_edge(key_t edge_key);
     key_t cut_edge(key_t edge_key);
     key_t paste_node(key_t node_key);
     key_t paste_edge(key_t edge_key);
 
   private:
-    std::vector<key_t> DFS_(Node<N, E> &nd, key_t end_key);
-    std::vector<Cycle> get_cycles_(Node<N, E> &nd, key_t root_key, key_t end_key);
-    std::vector<ColorT> preserve_colors_() const;
-    void recover_colors_(const std::vector<ColorT> &vec);
+    friend class GraphBuilder<N, E>;
+
+    // adjacency of live nodes in dominators cache indices, for DomTree updates
+    struct DomAdjacency_ {
+        const Graph &g;
+        size_t size() const { return g.m_dom_nodes.size(); }
+        template <typename F> void for_each_successor(idx_t node, F f) const;
+        template <typename F> void for_each_predecessor(idx_t node, F f) const;
+    };
+
+    void invalidate_analyses_();
+    // edge start->end was added/removed
+    void edge_changed_(key_t start_key, key_t end_key, bool inserted);
+    idx_t dom_index_(key_t key) const;
 
   protected:
     std::map<key_t, Node<N, E> *> m_nodes{};
     std::map<key_t, Edge<N, E> *> m_edges{};
+    // (start, end) -> key of edge in m_edges
+    std::unordered_map<EdgeEndsT, key_t, EdgeEndsHash> m_edge_index{};
     key_t m_actual_node_key{1};
     key_t m_actual_edge_key{1};
     std::map<key_t, Node<N, E> *> m_nodes_buf{};
     std::map<key_t, Edge<N, E> *> m_edges_buf{};
+
+  private:
+    // epoch of the latest traversal; node marks from older ones are stale
+    size_t m_visit_epoch{0};
+    // reusable DFS stack: (node, next successor to visit)
+    std::vector<std::pair<Node<N, E> *, typename Node<N, E>::AdjacencyIt>> m_dfs_stack{};
+
+    // modification counter; analyses remember the value they were built at
+    size_t m_mod_count{1};
+
+    // RPO cache
+    std::vector<key_t> m_rpo{};
+    key_t m_rpo_root{KEY_UNDEF};
+    size_t m_rpo_mod_count{0};
+
+    // dominators cache
+    DomTree m_dom_tree{};
+    bool m_dom_valid{false};
+    key_t m_dom_root{KEY_UNDEF};
+    // node set & indices of the view stay valid while the tree is, edges may be stale
+    CsrGraph m_dom_view{};
+    size_t m_dom_view_mod_count{0};
+    std::vector<Node<N, E> *> m_dom_nodes{};
+
+    // dominance frontier cache, built over dominators cache
+    DomFrontier m_df{};
+    key_t m_df_root{KEY_UNDEF};
+    size_t m_df_mod_count{0};
+
+    // post-dominators & control dependence cache over reversed view
+    CsrGraph m_pdom_view{};
+    DomTree m_pdom_tree{};
+    size_t m_pdom_mod_count{0};
+    DomFrontier m_cdg{};
+    size_t m_cdg_mod_count{0};
+
+    // loops cache
+    CsrGraph m_loop_view{};
+    LoopInfo m_loop_info{};
+    key_t m_loop_root{KEY_UNDEF};
+    size_t m_loop_mod_count{0};
+
+    // LCA caches: dominator tree over m_dom_view, DFS tree over m_lca_view
+    LcaIndex m_dom_lca{};
+    key_t m_dom_lca_root{KEY_UNDEF};
+    size_t m_dom_lca_mod_count{0};
+    CsrGraph m_lca_view{};
+    LcaIndex m_tree_lca{};
+    key_t m_tree_lca_root{KEY_UNDEF};
+    size_t m_tree_lca_mod_count{0};
+
+    // reachability cache
+    CsrGraph m_reach_view{};
+    Reachability m_reach{};
+    size_t m_reach_mod_count{0};
 };
 
 template <typename N, typename E>
@@ -348,6 +604,7 @@ template <typename N, typename E> key_t Graph<N, E>::add_node(N &node_data, key_
         return KEY_UNDEF;
     }
     m_actual_node_key++;
+    invalidate_analyses_();
     return node_key;
 }
 
@@ -363,27 +620,31 @@ template <typename N, typename E> key_t Graph<N, E>::add_nodes(N &node_data, siz
 }
 
 template <typename N, typename E> key_t Graph<N, E>::delete_node(key_t node_key) {
-    using edge_item_t = std::pair<key_t, Edge<N, E> *>;
     // find node X by key
     auto node_find_result = m_nodes.find(node_key);
     if (node_find_result == m_nodes.end()) {
         OPT(LOG("Wrong node key"));
         return KEY_UNDEF;
     }
-    std::vector<key_t> edges_to_delete{};
-    for (auto &itm : m_edges) {
-        key_t edge_key = itm.first;
-        Edge<N, E> *edge = itm.second;
-        if (edge->get_end_node_key() == node_key || edge->get_start_node_key() == node_key) {
-            edges_to_delete.push_back(edge_key);
+    // only X's own edges are touched; self loop leaves both lists at once
+    invalidate_analyses_();
+    Node<N, E> *node = node_find_result->second;
+    while (!node->out_edges().empty()) {
+        if (delete_edge(node->out_edges().back()) == KEY_UNDEF) {
+            OPT(LOG("Corrupted out edge list"));
+            return KEY_UNDEF;
         }
     }
-    for (auto key : edges_to_delete) {
-        delete_edge(key);
+    while (!node->in_edges().empty()) {
+        if (delete_edge(node->in_edges().back()) == KEY_UNDEF) {
+            OPT(LOG("Corrupted in edge list"));
+            return KEY_UNDEF;
+        }
     }
     // delete node X
     delete node_find_result->second;
     m_nodes.erase(node_key);
+    invalidate_analyses_();
     return node_key;
 }
 
@@ -393,20 +654,24 @@ template <typename N, typename E> key_t Graph<N, E>::cut_node(key_t node_key) {
         OPT(LOG("Wrong node key"));
         return KEY_UNDEF;
     }
-    std::vector<key_t> edges_to_cut{};
-    for (auto &itm : m_edges) {
-        key_t edge_key = itm.first;
-        Edge<N, E> *edge = itm.second;
-        if (edge->get_end_node_key() == node_key || edge->get_start_node_key() == node_key) {
-            edges_to_cut.push_back(edge_key);
+    invalidate_analyses_();
+    Node<N, E> *node = node_find_result->second;
+    while (!node->out_edges().empty()) {
+        if (cut_edge(node->out_edges().back()) == KEY_UNDEF) {
+            OPT(LOG("Corrupted out edge list"));
+            return KEY_UNDEF;
         }
     }
-    for (auto key : edges_to_cut) {
-        cut_edge(key);
+    while (!node->in_edges().empty()) {
+        if (cut_edge(node->in_edges().back()) == KEY_UNDEF) {
+            OPT(LOG("Corrupted in edge list"));
+            return KEY_UNDEF;
+        }
     }
 
     m_nodes_buf.insert(std::make_pair(node_key, m_nodes[node_key]));
     m_nodes.erase(node_key);
+    invalidate_analyses_();
     return node_key;
 }
 
@@ -430,9 +695,13 @@ template <typename N, typename E> key_t Graph<N, E>::cut_edge(key_t edge_key) {
         OPT(LOG("Cannot delete Successor/Predecessor during cut"));
         return KEY_UNDEF;
     }
+    m_nodes.at(start_node_key)->delete_out_edge(edge_key);
+    m_nodes.at(end_node_key)->delete_in_edge(edge_key);
 
-    m_edges.erase(edge_key);
     m_edges_buf.insert(std::make_pair(edge_key, result->second));
+    m_edges.erase(result);
+    m_edge_index.erase({start_node_key, end_node_key});
+    invalidate_analyses_();
     return edge_key;
 }
 
@@ -449,16 +718,12 @@ key_t Graph<N, E>::cut_edge(key_t start_node_key, key_t end_node_key) {
         OPT(LOG("Wrong end node key"));
         return KEY_UNDEF;
     }
-    for (auto &item : m_edges) {
-        key_t edge_key = item.first;
-        Edge<N, E> *edge = item.second;
-        if (edge->get_end_node_key() == end_node_key &&
-            edge->get_start_node_key() == start_node_key) {
-            return cut_edge(edge_key);
-        }
+    auto edge_it = m_edge_index.find({start_node_key, end_node_key});
+    if (edge_it == m_edge_index.end()) {
+        OPT(LOG("No edges selected for cut"));
+        return KEY_UNDEF;
     }
-    OPT(LOG("No edges selected for cut"));
-    return KEY_UNDEF;
+    return cut_edge(edge_it->second);
 }
 
 template <typename N, typename E>
@@ -474,16 +739,12 @@ key_t Graph<N, E>::get_edge_id(key_t start_node_key, key_t end_node_key) const {
         OPT(LOG("Wrong end node key"));
         return KEY_UNDEF;
     }
-    for (auto &item : m_edges) {
-        key_t edge_key = item.first;
-        Edge<N, E> *edge = item.second;
-        if (edge->get_end_node_key() == end_node_key &&
-            edge->get_start_node_key() == start_node_key) {
-            return edge_key;
-        }
+    auto edge_it = m_edge_index.find({start_node_key, end_node_key});
+    if (edge_it == m_edge_index.end()) {
+        OPT(LOG("No edges selected"));
+        return KEY_UNDEF;
     }
-    OPT(LOG("No edges selected for cut"));
-    return KEY_UNDEF;
+    return edge_it->second;
 }
 
 template <typename N, typename E>
@@ -519,7 +780,11 @@ key_t Graph<N, E>::add_edge(E &&edge_data, key_t start_node_key, key_t end_node_
         delete eptr;
         return KEY_UNDEF;
     }
+    m_edge_index.emplace(EdgeEndsT{start_node_key, end_node_key}, edge_key);
+    start_node_it->second->add_out_edge(edge_key);
+    end_node_it->second->add_in_edge(edge_key);
     m_actual_edge_key++;
+    edge_changed_(start_node_key, end_node_key, true);
     return edge_key;
 }
 
@@ -572,6 +837,7 @@ template <typename N, typename E> key_t Graph<N, E>::paste_edge(key_t edge_key)
         return KEY_UNDEF;
     }
     m_edges.insert(std::make_pair(edge_it->first, edge_it->second));
+    m_edge_index.emplace(EdgeEndsT{start_node_key, end_node_key}, edge_key);
     m_edges_buf.erase(edge_key);
     Node<N, E> *start_node = m_nodes.at(start_node_key);
     Node<N, E> *end_node = m_nodes.at(end_node_key);
@@ -580,6 +846,9 @@ template <typename N, typename E> key_t Graph<N, E>::paste_edge(key_t edge_key)
     if (key1 == KEY_UNDEF || key2 == KEY_UNDEF) {
         OPT(LOG("Cannot delete Successor/Predecessor during paste"));
     }
+    start_node->add_out_edge(edge_key);
+    end_node->add_in_edge(edge_key);
+    invalidate_analyses_();
     return edge_key;
 }
 
@@ -595,12 +864,71 @@ template <typename N, typename E> key_t Graph<N, E>::paste_node(key_t node_key)
         return KEY_UNDEF;
     }
 
-    m_nodes_buf.erase(node_key);
     m_nodes.insert(std::make_pair(node_find_result->first, node_find_result->second));
-
+    m_nodes_buf.erase(node_find_result);
+    invalidate_analyses_();
     return node_key;
 }
 
+template <typename N, typename E> KeyMapT Graph<N, E>::compact() {
+    if (!m_nodes_buf.empty() || !m_edges_buf.empty()) {
+        OPT(LOG("Cannot compact graph with cut nodes/edges"));
+        return {};
+    }
+    KeyMapT node_keys{};
+    KeyMapT edge_keys{};
+    node_keys.reserve(m_nodes.size());
+    edge_keys.reserve(m_edges.size());
+    // maps are ordered: new keys are monotonic, so sorted adjacency stays sorted
+    key_t key = 1;
+    for (auto &item : m_nodes) {
+        node_keys.emplace(item.first, key++);
+    }
+    key = 1;
+    for (auto &item : m_edges) {
+        edge_keys.emplace(item.first, key++);
+    }
+
+    std::map<key_t, Node<N, E> *> nodes{};
+    for (auto &item : m_nodes) {
+        Node<N, E> *node = item.second;
+        node->m_key = node_keys.at(item.first);
+        if (node->m_loop != KEY_UNDEF) {
+            auto loop = node_keys.find(node->m_loop);
+            node->m_loop = (loop == node_keys.end()) ? KEY_UNDEF : loop->second;
+        }
+        for (auto &adj : node->m_successors) {
+            adj.first = node_keys.at(adj.first);
+        }
+        for (auto &adj : node->m_predecessors) {
+            adj.first = node_keys.at(adj.first);
+        }
+        for (auto &edge_key : node->m_out_edges) {
+            edge_key = edge_keys.at(edge_key);
+        }
+        for (auto &edge_key : node->m_in_edges) {
+            edge_key = edge_keys.at(edge_key);
+        }
+        nodes.emplace_hint(nodes.end(), node->m_key, node);
+    }
+    std::map<key_t, Edge<N, E> *> edges{};
+    m_edge_index.clear();
+    for (auto &item : m_edges) {
+        Edge<N, E> *edge = item.second;
+        edge->m_key = edge_keys.at(item.first);
+        edge->m_start_node_key = node_keys.at(edge->m_start_node_key);
+        edge->m_end_node_key = node_keys.at(edge->m_end_node_key);
+        edges.emplace_hint(edges.end(), edge->m_key, edge);
+        m_edge_index.emplace(EdgeEndsT{edge->m_start_node_key, edge->m_end_node_key}, edge->m_key);
+    }
+    m_nodes = std::move(nodes);
+    m_edges = std::move(edges);
+    m_actual_node_key = static_cast<key_t>(m_nodes.size()) + 1;
+    m_actual_edge_key = static_cast<key_t>(m_edges.size()) + 1;
+    invalidate_analyses_();
+    return node_keys;
+}
+
 template <typename N, typename E> key_t Graph<N, E>::paste_all() {
     while (m_nodes_buf.size()) {
         key_t key = m_nodes_buf.rbegin()->first;
@@ -632,22 +960,12 @@ key_t Graph<N, E>::delete_edge(key_t start_node_key, key_t end_node_key) {
         OPT(LOG("Wrong end node key"));
         return KEY_UNDEF;
     }
-    for (auto &item : m_edges) {
-        key_t edge_key = item.first;
-        Edge<N, E> *edge = item.second;
-        if (edge->get_end_node_key() == end_node_key &&
-            edge->get_start_node_key() == start_node_key) {
-            key_t key1 = m_nodes.at(start_node_key)->delete_successor(end_node_key);
-            key_t key2 = m_nodes.at(end_node_key)->delete_predecessor(start_node_key);
-            if (key1 == KEY_UNDEF || key2 == KEY_UNDEF) {
-                OPT(LOG("Cannot delete Successor / Predecessor"));
-                return KEY_UNDEF;
-            }
-            return delete_edge(edge_key);
-        }
+    auto edge_it = m_edge_index.find({start_node_key, end_node_key});
+    if (edge_it == m_edge_index.end()) {
+        OPT(LOG("No edges selected"));
+        return KEY_UNDEF;
     }
-    OPT(LOG("No edges selected"));
-    return KEY_UNDEF;
+    return delete_edge(edge_it->second);
 }
 
 template <typename N, typename E> key_t Graph<N, E>::delete_edge(key_t edge_key) {
@@ -656,8 +974,27 @@ template <typename N, typename E> key_t Graph<N, E>::delete_edge(key_t edge_key)
         OPT(LOG("No such edge"));
         return KEY_UNDEF;
     }
-    m_edges.erase(edge_key);
-    delete result->second;
+    Edge<N, E> *edge = result->second;
+    key_t start_node_key = edge->get_start_node_key();
+    key_t end_node_key = edge->get_end_node_key();
+    auto start_node_it = m_nodes.find(start_node_key);
+    auto end_node_it = m_nodes.find(end_node_key);
+    if (start_node_it == m_nodes.end() || end_node_it == m_nodes.end()) {
+        OPT(LOG("No start/end node - cannot delete edge"));
+        return KEY_UNDEF;
+    }
+    key_t key1 = start_node_it->second->delete_successor(end_node_key);
+    key_t key2 = end_node_it->second->delete_predecessor(start_node_key);
+    if (key1 == KEY_UNDEF || key2 == KEY_UNDEF) {
+        OPT(LOG("Cannot delete Successor / Predecessor"));
+        return KEY_UNDEF;
+    }
+    start_node_it->second->delete_out_edge(edge_key);
+    end_node_it->second->delete_in_edge(edge_key);
+    m_edge_index.erase({start_node_key, end_node_key});
+    m_edges.erase(result);
+    delete edge;
+    edge_changed_(start_node_key, end_node_key, false);
     return edge_key;
 }
 
@@ -681,6 +1018,10 @@ template <typename N, typename E> size_t Graph<N, E>::get_node_count() const {
     return m_nodes.size();
 }
 
+template <typename N, typename E> size_t Graph<N, E>::get_mod_count() const {
+    return m_mod_count;
+}
+
 template <typename N, typename E> Graph<N, E>::~Graph() {
     for (auto &node_item : m_nodes) {
         auto node_ptr = node_item.second;
@@ -717,151 +1058,408 @@ template <typename N, typename E> std::string Graph<N, E>::dump() const {
 }
 
 template <typename N, typename E>
-std::vector<key_t> Graph<N, E>::DFS(key_t root_key, key_t end_key) {
+template <typename VisitorT>
+void Graph<N, E>::DFS_visit(key_t root_key, VisitorT &visitor) {
     auto res = m_nodes.find(root_key);
     if (res == m_nodes.end()) {
         OPT(LOG("No such node key"));
-        return {};
+        return;
     }
-    std::vector<ColorT> colors = preserve_colors_();
-    auto *node = res->second;
-    std::vector<key_t> vec{};
-    if (node->get_color() == ColorT::WHITE) {
-        vec = DFS_(*node, end_key);
+    const size_t epoch = ++m_visit_epoch;
+    auto &stack = m_dfs_stack;
+    stack.clear();
+    auto enter = [epoch, &stack, &visitor](Node<N, E> *node) {
+        node->set_enter_mark(epoch);
+        if (!visitor.pre(*node)) {
+            return false;
+        }
+        stack.emplace_back(node, node->successors_begin());
+        return true;
+    };
+    bool proceed = enter(res->second);
+    while (proceed && !stack.empty()) {
+        auto &top = stack.back();
+        Node<N, E> *node = top.first;
+        if (top.second == node->successors_end()) {
+            node->set_exit_mark(epoch);
+            visitor.post(*node);
+            stack.pop_back();
+            continue;
+        }
+        Node<N, E> *succ = (top.second++)->second;
+        if (succ->get_enter_mark() != epoch) {
+            proceed = enter(succ);
+        } else if (succ->get_exit_mark() != epoch) {
+            visitor.back_edge(*node, *succ);
+        }
     }
-    recover_colors_(colors);
-    return vec;
+    stack.clear();
 }
 
 template <typename N, typename E>
-std::vector<key_t> Graph<N, E>::DFS_(Node<N, E> &nd, key_t end_key) {
-    std::vector<key_t> vec{nd.get_key()};
-    if (nd.get_key() == end_key) {
-        nd.set_color(ColorT::BLACK);
-        return vec;
-    }
-    nd.set_color(ColorT::GRAY);
-    for (auto it = nd.successors_begin(); it != nd.successors_end(); it++) {
-        if (it->second->get_color() == ColorT::WHITE) {
-            std::vector<key_t> tmp = DFS_(*(it->second), end_key);
-            vec.insert(vec.end(), tmp.begin(), tmp.end());
-            if (vec.back() == end_key) {
-                nd.set_color(ColorT::BLACK);
-                return vec;
-            }
+void Graph<N, E>::DFS(key_t root_key, std::vector<key_t> &preorder, key_t end_key) {
+    struct Collector : DfsVisitor<N, E> {
+        Collector(std::vector<key_t> &out, key_t end) : out(out), end(end) {}
+        bool pre(Node<N, E> &node) {
+            out.push_back(node.get_key());
+            return node.get_key() != end;
         }
-    }
-    nd.set_color(ColorT::BLACK);
+        std::vector<key_t> &out;
+        key_t end;
+    };
+    preorder.clear();
+    Collector collector{preorder, end_key};
+    DFS_visit(root_key, collector);
+}
+
+template <typename N, typename E>
+std::vector<key_t> Graph<N, E>::DFS(key_t root_key, key_t end_key) {
+    std::vector<key_t> vec{};
+    DFS(root_key, vec, end_key);
     return vec;
 }
 
 template <typename N, typename E>
-std::vector<Cycle> Graph<N, E>::get_cycles(key_t root_key, key_t end_key) {
-    auto res = m_nodes.find(root_key);
-    if (res == m_nodes.end()) {
-        OPT(LOG("No such node key"));
-        return {};
-    }
-    std::vector<ColorT> colors = preserve_colors_();
-    auto *node = res->second;
+std::vector<Cycle> Graph<N, E>::get_cycles(key_t root_key, key_t /* end_key */) {
+    struct Collector : DfsVisitor<N, E> {
+        Collector(Graph<N, E> &g, std::vector<Cycle> &out) : g(g), out(out) {}
+        void back_edge(Node<N, E> &from, Node<N, E> &to) {
+            key_t edge_key = g.get_edge_id(from.get_key(), to.get_key());
+            out.emplace_back(to.get_key(), edge_key, from.get_key(), false);
+        }
+        Graph<N, E> &g;
+        std::vector<Cycle> &out;
+    };
     std::vector<Cycle> vec{};
-    if (node->get_color() == ColorT::WHITE) {
-        vec = get_cycles_(*node, root_key, end_key);
-    }
-    recover_colors_(colors);
+    Collector collector{*this, vec};
+    DFS_visit(root_key, collector);
     for (auto &cycle : vec) {
         if (is_a_dominates_b(root_key, cycle.head_node, cycle.back_edge_start)) {
             cycle.is_reducible = true;
         }
     }
-    // recover_colors_(colors);
     return vec;
 }
 
+template <typename N, typename E> KeyMapT Graph<N, E>::get_scc() const {
+    CsrGraph view = freeze();
+    std::vector<idx_t> component{};
+    view.SCC(component);
+    KeyMapT scc{};
+    scc.reserve(component.size());
+    for (idx_t i = 0; i < component.size(); ++i) {
+        scc.emplace(view.key(i), static_cast<key_t>(component[i]) + 1);
+    }
+    return scc;
+}
+
 template <typename N, typename E>
-std::vector<Cycle> Graph<N, E>::get_cycles_(Node<N, E> &nd, key_t root_key, key_t end_key) {
-    std::vector<Cycle> vec{};
-    // if (nd.get_key() == end_key) {
-    //     nd.set_color(ColorT::BLACK);
-    //     return vec;
-    // }
-    nd.set_color(ColorT::GRAY);
-    for (auto it = nd.successors_begin(); it != nd.successors_end(); it++) {
-        if (it->second->get_color() == ColorT::GRAY) {
-            key_t backedge_end = it->second->get_key();
-            key_t backedge_start = nd.get_key();
-            key_t edge_key = get_edge_id(backedge_start, backedge_end);
-            key_t head_key = backedge_end;
-            // bool reducible = !is_a_dominates_b(root_key, backedge_end, backedge_start);
-            Cycle c{head_key, edge_key, backedge_start, false};
-            vec.push_back(c);
+void Graph<N, E>::condense(const KeyMapT &scc, Graph<std::vector<key_t>, int> &dag,
+                           std::vector<std::vector<key_t>> &members) const {
+    key_t count{0};
+    for (auto &item : scc) {
+        count = std::max(count, item.second);
+    }
+    // dag nodes keep references into members, so no reallocation after this point
+    members.assign(count, {});
+    for (auto &item : m_nodes) {
+        auto id = scc.find(item.first);
+        if (id == scc.end()) {
+            OPT(LOG("Node w/o component"));
+            return;
+        }
+        members[id->second - 1].push_back(item.first);
+    }
+    for (key_t id = 1; id <= count; ++id) {
+        dag.add_node(members[id - 1], id);
+    }
+    for (auto &item : m_edges) {
+        key_t start = scc.at(item.second->get_start_node_key());
+        key_t end = scc.at(item.second->get_end_node_key());
+        if (start != end && dag.get_edge_id(start, end) == KEY_UNDEF) {
+            dag.add_edge(0, start, end);
         }
-        if (it->second->get_color() == ColorT::WHITE) {
-            std::vector<Cycle> tmp = get_cycles_(*(it->second), root_key, end_key);
-            vec.insert(vec.end(), tmp.begin(), tmp.end());
-            // if (vec.back() == end_key) {
-            //     nd.set_color(ColorT::BLACK);
-            //     return vec;
-            // }
+    }
+}
+
+template <typename N, typename E> void Graph<N, E>::freeze(CsrGraph &view) const {
+    std::vector<key_t> keys{};
+    std::vector<CsrGraph::EdgeT> edges{};
+    keys.reserve(m_nodes.size());
+    edges.reserve(m_edges.size());
+    // successors in key order, same as traversals over the graph itself
+    for (auto &item : m_nodes) {
+        keys.push_back(item.first);
+        for (auto it = item.second->successors_begin(); it != item.second->successors_end(); ++it) {
+            edges.push_back({item.first, it->first, get_edge_id(item.first, it->first)});
         }
     }
-    nd.set_color(ColorT::BLACK);
+    view.build(keys, edges);
+}
+
+template <typename N, typename E> CsrGraph Graph<N, E>::freeze() const {
+    CsrGraph view{};
+    freeze(view);
+    return view;
+}
+
+template <typename N, typename E>
+const std::vector<key_t> &Graph<N, E>::RPO(key_t root_key) {
+    if (m_rpo_mod_count == m_mod_count && m_rpo_root == root_key) {
+        return m_rpo;
+    }
+    struct Collector : DfsVisitor<N, E> {
+        Collector(std::vector<key_t> &out) : out(out) {}
+        void post(Node<N, E> &node) { out.push_back(node.get_key()); }
+        std::vector<key_t> &out;
+    };
+    m_rpo.clear();
+    Collector collector{m_rpo};
+    DFS_visit(root_key, collector);
+    std::reverse(m_rpo.begin(), m_rpo.end());
+    m_rpo_root = root_key;
+    m_rpo_mod_count = m_mod_count;
+    return m_rpo;
+}
+
+template <typename N, typename E> void Graph<N, E>::invalidate_analyses_() {
+    ++m_mod_count;
+    m_dom_valid = false;
+}
+
+template <typename N, typename E>
+void Graph<N, E>::edge_changed_(key_t start_key, key_t end_key, bool inserted) {
+    ++m_mod_count;
+    if (!m_dom_valid) {
+        return;
+    }
+    // long runs of edits w/o a query: rebuild lazily instead
+    if (m_dom_tree.pending() >= DomTree::PENDING_LIMIT) {
+        m_dom_valid = false;
+        return;
+    }
+    DomAdjacency_ adj{*this};
+    idx_t from = m_dom_view.index(start_key);
+    idx_t to = m_dom_view.index(end_key);
+    m_dom_valid = inserted ? m_dom_tree.insert_edge(adj, from, to)
+                           : m_dom_tree.delete_edge(adj, from, to);
+}
+
+template <typename N, typename E>
+template <typename F>
+void Graph<N, E>::DomAdjacency_::for_each_successor(idx_t node, F f) const {
+    Node<N, E> *nd = g.m_dom_nodes[node];
+    for (auto it = nd->successors_begin(); it != nd->successors_end(); ++it) {
+        f(g.m_dom_view.index(it->first));
+    }
+}
+
+template <typename N, typename E>
+template <typename F>
+void Graph<N, E>::DomAdjacency_::for_each_predecessor(idx_t node, F f) const {
+    Node<N, E> *nd = g.m_dom_nodes[node];
+    for (auto it = nd->predecessors_begin(); it != nd->predecessors_end(); ++it) {
+        f(g.m_dom_view.index(it->first));
+    }
+}
+
+template <typename N, typename E> idx_t Graph<N, E>::dom_index_(key_t key) const {
+    return m_dom_view.index(key);
+}
+
+template <typename N, typename E> const DomTree &Graph<N, E>::dom_tree(key_t root_key) {
+    if (m_dom_valid && m_dom_root == root_key) {
+        return m_dom_tree;
+    }
+    m_dom_valid = false;
+    m_dom_view.clear();
+    m_dom_tree.clear();
+    if (m_nodes.find(root_key) == m_nodes.end()) {
+        OPT(LOG("No such root key"));
+        return m_dom_tree;
+    }
+    freeze(m_dom_view);
+    m_dom_view_mod_count = m_mod_count;
+    m_dom_nodes.clear();
+    for (auto &item : m_nodes) {
+        m_dom_nodes.push_back(item.second);
+    }
+    m_dom_tree.build(m_dom_view.index(root_key), m_dom_view);
+    m_dom_root = root_key;
+    m_dom_valid = true;
+    return m_dom_tree;
+}
+
+template <typename N, typename E> key_t Graph<N, E>::get_idom(key_t root_key, key_t node_key) {
+    const DomTree &tree = dom_tree(root_key);
+    idx_t dom = tree.idom(dom_index_(node_key));
+    if (dom == IDX_UNDEF) {
+        return KEY_UNDEF;
+    }
+    return m_dom_view.key(dom);
+}
+
+template <typename N, typename E>
+const DomFrontier &Graph<N, E>::dom_frontier(key_t root_key) {
+    if (m_df_mod_count == m_mod_count && m_df_root == root_key) {
+        return m_df;
+    }
+    const DomTree &tree = dom_tree(root_key);
+    if (m_dom_view_mod_count != m_mod_count) {
+        // tree was updated in place, view edges are stale
+        freeze(m_dom_view);
+        m_dom_view_mod_count = m_mod_count;
+    }
+    m_df.build(tree, m_dom_view);
+    m_df_root = root_key;
+    m_df_mod_count = m_mod_count;
+    return m_df;
+}
+
+template <typename N, typename E>
+std::vector<key_t> Graph<N, E>::get_dom_frontier(key_t root_key, key_t node_key) {
+    const DomFrontier &df = dom_frontier(root_key);
+    idx_t node = dom_index_(node_key);
+    std::vector<key_t> vec{};
+    vec.reserve(df.get_frontier_size(node));
+    for (auto *it = df.frontier_begin(node); it != df.frontier_end(node); ++it) {
+        vec.push_back(m_dom_view.key(*it));
+    }
     return vec;
 }
 
-template <typename N, typename E> std::vector<ColorT> Graph<N, E>::preserve_colors_() const {
-    std::vector<ColorT> vec{};
-    for (auto &it : m_nodes) {
-        vec.push_back(it.second->get_color());
+template <typename N, typename E>
+std::vector<key_t> Graph<N, E>::get_iterated_dom_frontier(key_t root_key,
+                                                          const std::vector<key_t> &defs) {
+    const DomFrontier &df = dom_frontier(root_key);
+    std::vector<idx_t> def_nodes{};
+    def_nodes.reserve(defs.size());
+    for (key_t key : defs) {
+        def_nodes.push_back(dom_index_(key));
+    }
+    std::vector<idx_t> nodes{};
+    df.iterated(def_nodes, nodes);
+    // view is indexed in key order, so sorted indices give sorted keys
+    std::vector<key_t> vec{};
+    vec.reserve(nodes.size());
+    for (idx_t node : nodes) {
+        vec.push_back(m_dom_view.key(node));
     }
     return vec;
 }
 
+template <typename N, typename E> const DomTree &Graph<N, E>::post_dom_tree() {
+    if (m_pdom_mod_count == m_mod_count) {
+        return m_pdom_tree;
+    }
+    m_pdom_view.reverse(freeze());
+    m_pdom_tree.build(static_cast<idx_t>(m_nodes.size()), m_pdom_view);
+    m_pdom_mod_count = m_mod_count;
+    return m_pdom_tree;
+}
+
+template <typename N, typename E> key_t Graph<N, E>::get_ipdom(key_t node_key) {
+    const DomTree &tree = post_dom_tree();
+    idx_t pdom = tree.idom(m_pdom_view.index(node_key));
+    if (pdom == IDX_UNDEF) {
+        return KEY_UNDEF;
+    }
+    return m_pdom_view.key(pdom);
+}
+
+template <typename N, typename E> bool Graph<N, E>::is_a_postdominates_b(key_t a, key_t b) {
+    const DomTree &tree = post_dom_tree();
+    return tree.dominates(m_pdom_view.index(a), m_pdom_view.index(b));
+}
+
+template <typename N, typename E> const DomFrontier &Graph<N, E>::control_dependence() {
+    if (m_cdg_mod_count == m_mod_count) {
+        return m_cdg;
+    }
+    const DomTree &tree = post_dom_tree();
+    m_cdg.build(tree, m_pdom_view);
+    m_cdg_mod_count = m_mod_count;
+    return m_cdg;
+}
+
 template <typename N, typename E>
-void Graph<N, E>::recover_colors_(const std::vector<ColorT> &vec) {
-    if (vec.size() != m_nodes.size()) {
-        OPT(LOG("Wrong countity of colors"));
-        return;
+std::vector<key_t> Graph<N, E>::get_control_dependences(key_t node_key) {
+    const DomFrontier &cdg = control_dependence();
+    idx_t node = m_pdom_view.index(node_key);
+    std::vector<key_t> vec{};
+    vec.reserve(cdg.get_frontier_size(node));
+    for (auto *it = cdg.frontier_begin(node); it != cdg.frontier_end(node); ++it) {
+        vec.push_back(m_pdom_view.key(*it));
     }
+    return vec;
+}
 
-    auto i = 0;
-    for (auto &it : m_nodes) {
-        it.second->set_color(vec[i++]);
+template <typename N, typename E> const LoopInfo &Graph<N, E>::loop_info(key_t root_key) {
+    if (m_loop_mod_count == m_mod_count && m_loop_root == root_key) {
+        return m_loop_info;
     }
+    freeze(m_loop_view);
+    m_loop_info.build(m_loop_view.index(root_key), m_loop_view);
+    m_loop_root = root_key;
+    m_loop_mod_count = m_mod_count;
+    return m_loop_info;
 }
 
-template <typename N, typename E> std::vector<key_t> Graph<N, E>::RPO(key_t root_key) {
-    auto res = m_nodes.find(root_key);
-    if (res == m_nodes.end()) {
-        OPT(LOG("No such node key"));
-        return {};
+template <typename N, typename E>
+size_t Graph<N, E>::get_loop_depth(key_t root_key, key_t node_key) {
+    const LoopInfo &info = loop_info(root_key);
+    return info.depth(m_loop_view.index(node_key));
+}
+
+template <typename N, typename E>
+key_t Graph<N, E>::get_loop_header(key_t root_key, key_t node_key) {
+    const LoopInfo &info = loop_info(root_key);
+    idx_t header = info.loop(m_loop_view.index(node_key));
+    if (header == IDX_UNDEF) {
+        return KEY_UNDEF;
     }
+    return m_loop_view.key(header);
+}
+
+template <typename N, typename E>
+std::vector<key_t> Graph<N, E>::get_latches(key_t root_key, key_t header_key) {
+    const LoopInfo &info = loop_info(root_key);
+    idx_t header = m_loop_view.index(header_key);
     std::vector<key_t> vec{};
-    auto *node = res->second;
-    node->set_color(ColorT::BLACK);
-    std::queue<key_t> q{};
-    q.push(node->get_key());
-    while (!q.empty()) {
-        key_t key = q.front();
-        vec.push_back(key);
-        q.pop();
-        Node<N, E> *node = m_nodes[key];
-        for (auto it = node->successors_begin(); it != node->successors_end(); it++) {
-            Node<N, E> *nd = it->second;
-            if (nd->get_color() != ColorT::BLACK) {
-                // vec.push_back(nd->get_key());
-                nd->set_color(ColorT::BLACK);
-                q.push(nd->get_key());
-            }
-        }
+    for (auto *it = info.latches_begin(header); it != info.latches_end(header); ++it) {
+        vec.push_back(m_loop_view.key(*it));
     }
-    for (auto &it : m_nodes) {
-        it.second->set_color(ColorT::WHITE);
+    return vec;
+}
+
+template <typename N, typename E>
+std::vector<EdgeEndsT> Graph<N, E>::get_loop_exits(key_t root_key, key_t header_key) {
+    const LoopInfo &info = loop_info(root_key);
+    idx_t header = m_loop_view.index(header_key);
+    std::vector<EdgeEndsT> vec{};
+    for (auto *it = info.exits_begin(header); it != info.exits_end(header); ++it) {
+        vec.emplace_back(m_loop_view.key(it->first), m_loop_view.key(it->second));
     }
     return vec;
 }
 
-// not tested yet
+template <typename N, typename E>
+key_t Graph<N, E>::get_preheader(key_t root_key, key_t header_key) {
+    const LoopInfo &info = loop_info(root_key);
+    idx_t preheader = info.preheader(m_loop_view.index(header_key));
+    if (preheader == IDX_UNDEF) {
+        return KEY_UNDEF;
+    }
+    return m_loop_view.key(preheader);
+}
+
+template <typename N, typename E>
+bool Graph<N, E>::is_loop_irreducible(key_t root_key, key_t header_key) {
+    const LoopInfo &info = loop_info(root_key);
+    return info.forest().is_irreducible(m_loop_view.index(header_key));
+}
+
+/// @return target and all nodes dominated by it (dominator subtree in preorder)
 template <typename N, typename E>
 std::vector<key_t> Graph<N, E>::getDominatedNodes(key_t root_key, key_t target_key) {
     auto res = m_nodes.find(root_key);
@@ -874,47 +1472,108 @@ std::vector<key_t> Graph<N, E>::getDominatedNodes(key_t root_key, key_t target_k
         OPT(LOG("No such target key"));
         return std::vector<key_t>{KEY_UNDEF};
     }
-    std::vector<key_t> origin = DFS(root_key);
-    // for (auto x: origin) {
-    //     std::cerr << x << " ";
-    // }
-    // std::cerr << "\n";
-    // std::set<key_t> initial_nodes(tmp.begin(), tmp.end());
-    cut_node(target_key);
-    std::vector<key_t> reduced = DFS(root_key);
-    // for (auto x: reduced) {
-    //     std::cerr << x << " ";
-    // }
-    // std::cerr << "\n";
-    for (auto node_key : reduced) {
-        for (auto it = origin.begin(); it != origin.end(); ++it) {
-            if (*it == node_key) {
-                origin.erase(it);
-                break;
-            }
+    const DomTree &tree = dom_tree(root_key);
+    idx_t target = dom_index_(target_key);
+    if (!tree.reachable(target)) {
+        return {};
+    }
+    std::vector<key_t> vec{};
+    std::vector<idx_t> stack{target};
+    while (!stack.empty()) {
+        idx_t cur = stack.back();
+        stack.pop_back();
+        vec.push_back(m_dom_view.key(cur));
+        for (auto *it = tree.children_end(cur); it != tree.children_begin(cur);) {
+            stack.push_back(*--it);
         }
     }
-    paste_all();
-    return origin;
+    return vec;
 }
 
 template <typename N, typename E>
 bool Graph<N, E>::is_a_dominates_b(key_t root_key, key_t a, key_t b) {
-    auto employees = getDominatedNodes(root_key, a);
-    for (auto &key : employees) {
-        if (b == key) {
-            return true;
-        }
+    const DomTree &tree = dom_tree(root_key);
+    return tree.dominates(dom_index_(a), dom_index_(b));
+}
+
+template <typename N, typename E> const LcaIndex &Graph<N, E>::dom_lca(key_t root_key) {
+    const DomTree &tree = dom_tree(root_key);
+    if (m_dom_lca_mod_count == m_mod_count && m_dom_lca_root == root_key) {
+        return m_dom_lca;
+    }
+    m_dom_lca.build(tree);
+    m_dom_lca_root = root_key;
+    m_dom_lca_mod_count = m_mod_count;
+    return m_dom_lca;
+}
+
+template <typename N, typename E>
+key_t Graph<N, E>::get_nearest_common_dominator(key_t root_key, key_t a, key_t b) {
+    const LcaIndex &index = dom_lca(root_key);
+    idx_t res = index.lca(dom_index_(a), dom_index_(b));
+    if (res == IDX_UNDEF) {
+        return KEY_UNDEF;
+    }
+    return m_dom_view.key(res);
+}
+
+template <typename N, typename E>
+key_t Graph<N, E>::get_tree_lca(key_t root_key, key_t a, key_t b) {
+    if (m_tree_lca_mod_count != m_mod_count || m_tree_lca_root != root_key) {
+        freeze(m_lca_view);
+        // DFS tree parents; nodes not reachable from root are roots of their own
+        struct Parents : CsrVisitor {
+            Parents(size_t n) : parent(n, IDX_UNDEF) {}
+            bool pre(idx_t node) {
+                parent[node] = path.empty() ? IDX_UNDEF : path.back();
+                path.push_back(node);
+                return true;
+            }
+            void post(idx_t) { path.pop_back(); }
+            std::vector<idx_t> parent;
+            std::vector<idx_t> path{};
+        };
+        Parents dfs{m_lca_view.size()};
+        m_lca_view.DFS_visit(m_lca_view.index(root_key), dfs);
+        m_tree_lca.build(dfs.parent);
+        m_tree_lca_root = root_key;
+        m_tree_lca_mod_count = m_mod_count;
+    }
+    idx_t res = m_tree_lca.lca(m_lca_view.index(a), m_lca_view.index(b));
+    if (res == IDX_UNDEF || m_tree_lca.root(res) != m_lca_view.index(root_key)) {
+        return KEY_UNDEF;
     }
-    return false;
+    return m_lca_view.key(res);
 }
 
 template <typename N, typename E> bool Graph<N, E>::hasPath(key_t start, key_t end) {
-    auto path = DFS(start, end);
-    if (path.size() == 0 || path.back() != end) {
-        return false;
+    struct Finder : DfsVisitor<N, E> {
+        Finder(key_t end) : end(end) {}
+        bool pre(Node<N, E> &node) {
+            found = (node.get_key() == end);
+            return !found;
+        }
+        key_t end;
+        bool found{false};
+    };
+    Finder finder{end};
+    DFS_visit(start, finder);
+    return finder.found;
+}
+
+template <typename N, typename E> const Reachability &Graph<N, E>::reachability() {
+    if (m_reach_mod_count == m_mod_count) {
+        return m_reach;
     }
-    return true;
+    freeze(m_reach_view);
+    m_reach.build(m_reach_view);
+    m_reach_mod_count = m_mod_count;
+    return m_reach;
+}
+
+template <typename N, typename E> bool Graph<N, E>::reachable(key_t start, key_t end) {
+    const Reachability &index = reachability();
+    return index.reaches(m_reach_view.index(start), m_reach_view.index(end));
 }
 
 } // namespace G
@@ -0,0 +1,178 @@
+#pragma once
+#include "config.hpp"
+#include "graph.hpp"
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace G {
+
+/// @brief node data hooks of GraphBuilder: key used when none is given (KEY_UNDEF - next free
+/// key) & write-back of the final key; specialize where graph keeps keys inside node data
+template <typename N> struct BuilderNodeTraits {
+    static key_t default_key(const N &) { return KEY_UNDEF; }
+    static void set_key(N &, key_t) {}
+};
+
+/// @brief collects node & edge arrays and fills an empty Graph in one pass: storage is presized,
+/// adjacency is laid out already sorted, no per-edge lookups. Duplicate edges are found for
+/// free once edges are sorted, so the result is the same as from add_node/add_edge calls
+template <typename N, typename E> class GraphBuilder {
+  public:
+    GraphBuilder() = default;
+
+    void reserve(size_t node_count, size_t edge_count);
+    void clear();
+    /// @brief node data is referred to, not copied (same as Graph::add_node)
+    /// @return node key; w/o given one BuilderNodeTraits decide, then keys continue after the
+    /// greatest key so far
+    key_t add_node(N &node_data, key_t key = KEY_UNDEF);
+    void add_edge(E &&edge_data, key_t start_node_key, key_t end_node_key);
+    /// @brief g must be empty; edges get keys in the order they were added. Builder is cleared
+    /// @return greatest node key or KEY_UNDEF in case of error (duplicate node or edge, unknown
+    /// end); g is left untouched then
+    key_t build(Graph<N, E> &g);
+
+  private:
+    struct NodeT {
+        key_t key;
+        N *data;
+    };
+    struct EdgeT {
+        key_t start;
+        key_t end;
+        E data;
+    };
+
+    std::vector<NodeT> m_nodes{};
+    std::vector<EdgeT> m_edges{};
+    key_t m_actual_node_key{1};
+};
+
+template <typename N, typename E>
+void GraphBuilder<N, E>::reserve(size_t node_count, size_t edge_count) {
+    m_nodes.reserve(node_count);
+    m_edges.reserve(edge_count);
+}
+
+template <typename N, typename E> void GraphBuilder<N, E>::clear() {
+    m_nodes.clear();
+    m_edges.clear();
+    m_actual_node_key = 1;
+}
+
+template <typename N, typename E> key_t GraphBuilder<N, E>::add_node(N &node_data, key_t key) {
+    if (key == KEY_UNDEF) {
+        key = BuilderNodeTraits<N>::default_key(node_data);
+    }
+    if (key == KEY_UNDEF) {
+        key = m_actual_node_key;
+    }
+    m_actual_node_key = std::max(key + 1, m_actual_node_key);
+    m_nodes.push_back({key, &node_data});
+    return key;
+}
+
+template <typename N, typename E>
+void GraphBuilder<N, E>::add_edge(E &&edge_data, key_t start_node_key, key_t end_node_key) {
+    m_edges.push_back({start_node_key, end_node_key, std::move(edge_data)});
+}
+
+template <typename N, typename E> key_t GraphBuilder<N, E>::build(Graph<N, E> &g) {
+    if (!g.m_nodes.empty() || !g.m_edges.empty() || !g.m_nodes_buf.empty() ||
+        !g.m_edges_buf.empty()) {
+        OPT(LOG("Graph is not empty"));
+        return KEY_UNDEF;
+    }
+    const size_t n = m_nodes.size();
+    const size_t m = m_edges.size();
+    std::sort(m_nodes.begin(), m_nodes.end(),
+              [](const NodeT &a, const NodeT &b) { return a.key < b.key; });
+    for (size_t i = 0; i < n; ++i) {
+        if (m_nodes[i].key <= KEY_UNDEF || (i > 0 && m_nodes[i].key == m_nodes[i - 1].key)) {
+            OPT(LOG("Wrong node key"));
+            return KEY_UNDEF;
+        }
+    }
+    // edge ends as positions in m_nodes
+    auto position = [this](key_t key) {
+        auto it = std::lower_bound(m_nodes.begin(), m_nodes.end(), key,
+                                   [](const NodeT &item, key_t k) { return item.key < k; });
+        return (it == m_nodes.end() || it->key != key) ? IDX_UNDEF
+                                                       : static_cast<idx_t>(it - m_nodes.begin());
+    };
+    std::vector<std::pair<idx_t, idx_t>> ends(m);
+    std::vector<idx_t> succ_begin(n + 1, 0);
+    std::vector<idx_t> pred_begin(n + 1, 0);
+    for (size_t i = 0; i < m; ++i) {
+        ends[i] = {position(m_edges[i].start), position(m_edges[i].end)};
+        if (ends[i].first == IDX_UNDEF || ends[i].second == IDX_UNDEF) {
+            OPT(LOG("Wrong start/end node key"));
+            return KEY_UNDEF;
+        }
+        ++succ_begin[ends[i].first + 1];
+        ++pred_begin[ends[i].second + 1];
+    }
+    for (size_t i = 0; i < n; ++i) {
+        succ_begin[i + 1] += succ_begin[i];
+        pred_begin[i + 1] += pred_begin[i];
+    }
+    // neighbour positions bucketed by node, then sorted inside each bucket
+    std::vector<idx_t> succs(m);
+    std::vector<idx_t> preds(m);
+    std::vector<idx_t> succ_fill(succ_begin.begin(), succ_begin.end() - 1);
+    std::vector<idx_t> pred_fill(pred_begin.begin(), pred_begin.end() - 1);
+    for (auto &item : ends) {
+        succs[succ_fill[item.first]++] = item.second;
+        preds[pred_fill[item.second]++] = item.first;
+    }
+    for (size_t i = 0; i < n; ++i) {
+        std::sort(succs.begin() + succ_begin[i], succs.begin() + succ_begin[i + 1]);
+        std::sort(preds.begin() + pred_begin[i], preds.begin() + pred_begin[i + 1]);
+        if (std::adjacent_find(succs.begin() + succ_begin[i], succs.begin() + succ_begin[i + 1]) !=
+            succs.begin() + succ_begin[i + 1]) {
+            OPT(LOG("Such edge has already exists"));
+            return KEY_UNDEF;
+        }
+    }
+
+    // nodes come in key order: every insertion goes to the end of the map
+    std::vector<Node<N, E> *> nodes(n);
+    for (size_t i = 0; i < n; ++i) {
+        auto *nptr = new Node<N, E>{*m_nodes[i].data, g};
+        nptr->set_key(m_nodes[i].key);
+        BuilderNodeTraits<N>::set_key(*m_nodes[i].data, m_nodes[i].key);
+        nptr->m_successors.reserve(succ_begin[i + 1] - succ_begin[i]);
+        nptr->m_predecessors.reserve(pred_begin[i + 1] - pred_begin[i]);
+        nptr->m_out_edges.reserve(succ_begin[i + 1] - succ_begin[i]);
+        nptr->m_in_edges.reserve(pred_begin[i + 1] - pred_begin[i]);
+        g.m_nodes.emplace_hint(g.m_nodes.end(), m_nodes[i].key, nptr);
+        nodes[i] = nptr;
+    }
+    for (size_t i = 0; i < n; ++i) {
+        for (idx_t j = succ_begin[i]; j < succ_begin[i + 1]; ++j) {
+            nodes[i]->m_successors.push_back({m_nodes[succs[j]].key, nodes[succs[j]]});
+        }
+        for (idx_t j = pred_begin[i]; j < pred_begin[i + 1]; ++j) {
+            nodes[i]->m_predecessors.push_back({m_nodes[preds[j]].key, nodes[preds[j]]});
+        }
+    }
+    g.m_edge_index.reserve(m);
+    for (size_t i = 0; i < m; ++i) {
+        auto &edge = m_edges[i];
+        auto *eptr = new Edge<N, E>{std::move(edge.data), g, edge.start, edge.end};
+        key_t edge_key = eptr->key_init();
+        g.m_edges.emplace_hint(g.m_edges.end(), edge_key, eptr);
+        g.m_edge_index.emplace(EdgeEndsT{edge.start, edge.end}, edge_key);
+        nodes[ends[i].first]->add_out_edge(edge_key);
+        nodes[ends[i].second]->add_in_edge(edge_key);
+        ++g.m_actual_edge_key;
+    }
+    key_t last = (n == 0) ? KEY_UNDEF : m_nodes.back().key;
+    g.m_actual_node_key = (n == 0) ? g.m_actual_node_key : last + 1;
+    g.invalidate_analyses_();
+    clear();
+    return last;
+}
+
+} // namespace G
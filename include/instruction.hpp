@@ -1,8 +1,9 @@
 #pragma once
 #include "types.hpp"
 #include <cstdint>
+#include <cstddef>
 #include <exception>
-#include <list>
+#include <iterator>
 #include <optional>
 #include <string>
 #include <unistd.h>
@@ -82,12 +83,82 @@ enum class FlowT { NONE, DEF, USE };
 // contain instr id and bb id
 // metainstruction w/ Inputs
 
+/// @brief operand slot of user: refers to a definition & is linked into its use-list
+/// moves relink the slot, so operands may live in a growable array of user
+class Use final {
+  public:
+    Use() = default;
+    Use(const Use &) = delete;
+    Use &operator=(const Use &) = delete;
+    ~Use();
+
+    InstrBase *get() const { return m_val; }
+    InstrBase *user() const { return m_user; }
+    /// @brief next use of the same definition
+    Use *next() const { return m_next; }
+    /// @brief O(1): leave use-list of current definition, join the one of val (may be nullptr)
+    void set(InstrBase *val);
+
+  private:
+    friend class InstrBase;
+    void link_(InstrBase *val);
+    void unlink_();
+    // take place of other (this must be unlinked); other ends up unlinked
+    void relocate_(Use &other);
+
+  private:
+    InstrBase *m_val{nullptr};
+    InstrBase *m_user{nullptr};
+    Use *m_next{nullptr};
+    // slot pointing to this: use-list head of m_val or m_next of previous use
+    Use **m_prev{nullptr};
+};
+
 class InstrBase {
   public:
-    using UsersT = std::list<InstrBase *>;
-    using InputsT = std::list<InstrBase *>;
-    using InputListIt = typename InputsT::iterator;
-    using UserListIt = typename UsersT::iterator;
+    /// @brief operands as definitions, in operand order
+    class InputIt {
+      public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = InstrBase *;
+        using difference_type = std::ptrdiff_t;
+        using pointer = InstrBase *const *;
+        using reference = InstrBase *;
+
+        InputIt(const Use *use) : m_use(use) {}
+        InstrBase *operator*() const { return m_use->get(); }
+        InputIt &operator++() {
+            ++m_use;
+            return *this;
+        }
+        bool operator==(const InputIt &other) const { return m_use == other.m_use; }
+        bool operator!=(const InputIt &other) const { return m_use != other.m_use; }
+
+      private:
+        const Use *m_use;
+    };
+    /// @brief users along the use-list, one per use (latest use first)
+    class UserIt {
+      public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = InstrBase *;
+        using difference_type = std::ptrdiff_t;
+        using pointer = InstrBase *const *;
+        using reference = InstrBase *;
+
+        UserIt(const Use *use) : m_use(use) {}
+        InstrBase *operator*() const { return m_use->user(); }
+        const Use *use() const { return m_use; }
+        UserIt &operator++() {
+            m_use = m_use->next();
+            return *this;
+        }
+        bool operator==(const UserIt &other) const { return m_use == other.m_use; }
+        bool operator!=(const UserIt &other) const { return m_use != other.m_use; }
+
+      private:
+        const Use *m_use;
+    };
 
   public:
     virtual ~InstrBase();
@@ -95,6 +166,8 @@ class InstrBase {
     InstrBase(id_t id);
     // InstrBase(BasicBlock &bb);
     InstrBase(BasicBlock &bb, id_t id);
+    InstrBase(const InstrBase &) = delete;
+    InstrBase &operator=(const InstrBase &) = delete;
     // InstrBase(id_t id);
     // InstrBase(const BasicBlock &bb, id_t id, initList list);
 
@@ -102,27 +175,41 @@ class InstrBase {
     void set_next(InstrBase *instr);
     void set_bb(BasicBlock *bb);
     void set_id(id_t id);
+    void set_order(size_t order);
 
+    /// @brief append operand; O(1), no allocation while operands fit inline
     void push_input(InstrBase *instr);
     void push_inputs(initList list);
     void push_user(InstrBase *instr);
     void push_users(initList list);
 
+    /// @brief drop cfg links & own operands; users keep this as their input
     void forget_dependencies();
-    InputListIt inputs_begin();
-    InputListIt inputs_end();
-    InputListIt inputs_last();
+    /// @brief remove every operand; O(number of operands)
+    void drop_inputs();
+    /// @brief remove this from operands of every user
+    void drop_users();
+    InputIt inputs_begin() const;
+    InputIt inputs_end() const;
+    size_t input_count() const;
+    InstrBase *input(size_t index) const;
+    Use &input_use(size_t index);
     bool onlyOneInput() const;
     bool onlyOneUser() const;
-    // InputListIt erase_input(InputListIt cit);
+    /// @brief remove all operands defined by instr id in bb bb_id
     bool erase_input(id_t bb_id, id_t id);
-    UserListIt users_begin();
-    UserListIt users_end();
-    UserListIt users_last();
-    // UserListIt erase_user(UserListIt cit);
+    /// @brief remove operand by position; later operands shift left
+    void erase_input(size_t index);
+    UserIt users_begin() const;
+    UserIt users_end() const;
+    /// @brief number of uses; O(1)
+    size_t user_count() const;
+    /// @brief remove this from operands of users w/ instr id in bb bb_id
     bool erase_user(id_t bb_id, id_t id);
-    UsersT &users() &;
-    InputsT &inputs() &;
+    /// @brief rewrite operand in place; O(1), operand positions stay the same
+    void setOperand(size_t index, InstrBase *instr);
+    /// @brief every use of this refers to instr afterwards; O(number of uses)
+    void replaceAllUsesWith(InstrBase *instr);
 
     virtual std::string dump() const;
     void throwIfNotConsistent_() const;
@@ -132,14 +219,28 @@ class InstrBase {
     InstrBase *next() const;
     BasicBlock *bb() const;
     id_t get_id() const;
+    // position inside bb; valid only while bb keeps its numbering
+    size_t order() const;
+
+  private:
+    friend class Use;
+    static constexpr size_t INLINE_INPUTS = 2;
+    void reserve_inputs_(size_t capacity);
 
   protected:
     id_t m_id{ID_UNDEF};
+    size_t m_order{0};
     BasicBlock *m_bb{nullptr};
     InstrBase *m_prev{nullptr};
     InstrBase *m_next{nullptr};
-    UsersT m_users{};
-    InputsT m_inputs{};
+    // use-list: uses of this as an operand of other instrs
+    Use *m_users{nullptr};
+    size_t m_user_count{0};
+    // operands: inline slots, spilled to heap beyond INLINE_INPUTS
+    Use m_inline_inputs[INLINE_INPUTS]{};
+    Use *m_inputs{m_inline_inputs};
+    size_t m_input_count{0};
+    size_t m_input_capacity{INLINE_INPUTS};
 };
 
 class Instr : public InstrBase {
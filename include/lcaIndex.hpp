@@ -0,0 +1,41 @@
+#pragma once
+#include "config.hpp"
+#include "csrGraph.hpp"
+#include "domTree.hpp"
+#include <vector>
+
+namespace G {
+
+/// @brief lowest common ancestor queries over a forest of densely indexed nodes
+/// sparse table of minima over tree preorder: LCA of u, v (u first in preorder) is the parent
+/// of the shallowest node in preorder range (u, v]. O(1) query, n log n table
+class LcaIndex {
+  public:
+    LcaIndex() = default;
+
+    /// @brief forest by parents: IDX_UNDEF marks roots
+    void build(const std::vector<idx_t> &parent);
+    /// @brief dominator tree; unreachable nodes are left out
+    void build(const DomTree &tree);
+    void clear();
+
+    size_t size() const;
+    bool contains(idx_t node) const;
+    /// @return root of the tree containing node; IDX_UNDEF if left out
+    idx_t root(idx_t node) const;
+    /// @return lowest common ancestor; IDX_UNDEF if a, b are in different trees or left out
+    idx_t lca(idx_t a, idx_t b) const;
+
+  private:
+    std::vector<idx_t> m_parent{};
+    std::vector<idx_t> m_root{};
+    // preorder position of node & node at position
+    std::vector<idx_t> m_in{};
+    std::vector<idx_t> m_order{};
+    // m_table[k][i]: smallest preorder position of a parent among positions [i, i + 2^k)
+    std::vector<std::vector<idx_t>> m_table{};
+    // floor of log2 by range length
+    std::vector<idx_t> m_log{};
+};
+
+} // namespace G
@@ -0,0 +1,85 @@
+#pragma once
+#include "config.hpp"
+#include "csrGraph.hpp"
+#include <utility>
+#include <vector>
+
+namespace G {
+
+/// @brief loop nesting forest over densely indexed nodes
+/// built by Havlak's algorithm w/ union-find; entries of irreducible loops are merged into
+/// enclosing loops small-to-large instead of being copied level by level. A loop is identified
+/// by its header, the DFS-first node of the loop; irreducible loops have other entries
+class LoopForest {
+  public:
+    LoopForest() = default;
+
+    /// @brief find loops among nodes reachable from root
+    void build(idx_t root, const CsrGraph &g);
+    void clear();
+
+    size_t size() const;
+    bool is_header(idx_t node) const;
+    /// @return true if loop of header can be entered not only through header
+    bool is_irreducible(idx_t header) const;
+    /// @return header of innermost loop containing node (header itself for headers);
+    /// IDX_UNDEF outside of loops
+    idx_t loop(idx_t node) const;
+    /// @return header of the enclosing loop; IDX_UNDEF for outermost loops & non-headers
+    idx_t parent(idx_t header) const;
+    /// @return start of one back edge to header; IDX_UNDEF for non-headers
+    idx_t back_edge_start(idx_t header) const;
+    /// @brief headers in DFS preorder: outer loops come before inner ones
+    const std::vector<idx_t> &headers() const;
+
+  private:
+    enum class LoopT : uint8_t { NONE, REDUCIBLE, IRREDUCIBLE };
+
+    std::vector<LoopT> m_type{};
+    // innermost enclosing header; for a header it is the header of its parent loop
+    std::vector<idx_t> m_header{};
+    std::vector<idx_t> m_back_edge_start{};
+    std::vector<idx_t> m_headers{};
+};
+
+/// @brief per-loop queries over a loop forest, same dense indices; loops are named by headers
+class LoopInfo {
+  public:
+    LoopInfo() = default;
+
+    /// @brief build loop forest from root & derived loop data
+    void build(idx_t root, const CsrGraph &g);
+    void clear();
+
+    const LoopForest &forest() const;
+    /// @return number of loops containing node; 0 outside of loops
+    idx_t depth(idx_t node) const;
+    /// @return header of innermost loop containing node; IDX_UNDEF outside of loops
+    idx_t loop(idx_t node) const;
+    /// @brief O(1) check via loop tree numbering
+    bool contains(idx_t header, idx_t node) const;
+    /// @brief loop nodes w/ back edge to header
+    const idx_t *latches_begin(idx_t header) const;
+    const idx_t *latches_end(idx_t header) const;
+    /// @brief (inside, outside) edges leaving loop of header, nested loops included
+    const std::pair<idx_t, idx_t> *exits_begin(idx_t header) const;
+    const std::pair<idx_t, idx_t> *exits_end(idx_t header) const;
+    /// @return the only predecessor of header outside of loop if header is its only successor;
+    /// IDX_UNDEF otherwise & for irreducible loops
+    idx_t preheader(idx_t header) const;
+
+  private:
+    LoopForest m_forest{};
+    std::vector<idx_t> m_depth{};
+    // loop tree preorder number & loop subtree size, by header
+    std::vector<idx_t> m_tree_in{};
+    std::vector<idx_t> m_tree_size{};
+    std::vector<idx_t> m_preheader{};
+    // latches of i are m_latches[m_latch_begin[i]..[i + 1]), same for exits
+    std::vector<idx_t> m_latch_begin{};
+    std::vector<idx_t> m_latches{};
+    std::vector<idx_t> m_exit_begin{};
+    std::vector<std::pair<idx_t, idx_t>> m_exits{};
+};
+
+} // namespace G
@@ -0,0 +1,172 @@
+#pragma once
+#include "bbGraph.hpp"
+#include "instruction.hpp"
+#include "memManager.hpp"
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+/// @brief phy input flowing into phy's bb through pred: the closest input dominating pred
+/// @return nullptr if no input dominates pred
+IR::InstrBase *phyIncoming(IR::BbGraph &g, IR::Phy *phy, G::key_t pred) {
+    G::key_t root = g.accessHeader()->get_key();
+    IR::InstrBase *best{nullptr};
+    for (auto it = phy->inputs_begin(); it != phy->inputs_end(); ++it) {
+        G::key_t bb = (*it)->bb()->get_id();
+        if (!g.is_a_dominates_b(root, bb, pred)) {
+            continue;
+        }
+        if (best == nullptr || g.is_a_dominates_b(root, best->bb()->get_id(), bb)) {
+            best = *it;
+        }
+    }
+    return best;
+}
+
+/// @brief route edges preds -> bb through a new block; phys of bb get values coming from preds
+/// merged by a new phy in that block if they differ
+/// @return key of the new block or KEY_UNDEF in case of error; CFG is left untouched then
+G::key_t splitPredecessors(IR::BbGraph &g, G::key_t bb_key, const std::vector<G::key_t> &preds,
+                           IR::BasicBlockManager &bbs, IR::InstrManager &instrs) {
+    auto *node = g.at(bb_key);
+    if (node == nullptr || preds.empty()) {
+        return G::KEY_UNDEF;
+    }
+    for (auto it = preds.begin(); it != preds.end(); ++it) {
+        if (g.get_edge_id(*it, bb_key) == G::KEY_UNDEF || std::find(preds.begin(), it, *it) != it) {
+            OPT(LOG("Wrong predecessor for split"));
+            return G::KEY_UNDEF;
+        }
+    }
+    // phy inputs per incoming edge, before the CFG changes
+    struct PhyFlow {
+        IR::Phy *phy;
+        std::vector<IR::InstrBase *> moved;
+        std::vector<IR::InstrBase *> kept;
+    };
+    std::vector<PhyFlow> flows{};
+    auto &bb = node->data();
+    for (auto it = bb.phy_begin(); it != bb.phy_end(); ++it) {
+        PhyFlow flow{*it, {}, {}};
+        for (auto pred = node->predecessors_begin(); pred != node->predecessors_end(); ++pred) {
+            IR::InstrBase *input = phyIncoming(g, *it, pred->first);
+            bool split = std::find(preds.begin(), preds.end(), pred->first) != preds.end();
+            auto &values = split ? flow.moved : flow.kept;
+            if (input != nullptr && std::find(values.begin(), values.end(), input) == values.end()) {
+                values.push_back(input);
+            }
+        }
+        flows.push_back(std::move(flow));
+    }
+
+    auto *new_bb = bbs.create();
+    G::key_t new_key = g.add_node(*new_bb);
+    if (new_key == G::KEY_UNDEF) {
+        OPT(LOG("Cannot add block for split"));
+        return G::KEY_UNDEF;
+    }
+    // put back edges rerouted so far & drop the new block
+    auto rollback = [&](size_t rerouted) {
+        for (size_t i = 0; i < rerouted; ++i) {
+            g.delete_edge(preds[i], new_key);
+            g.add_edge(0, preds[i], bb_key);
+        }
+        g.delete_node(new_key);
+    };
+    for (size_t i = 0; i < preds.size(); ++i) {
+        if (g.delete_edge(preds[i], bb_key) == G::KEY_UNDEF) {
+            OPT(LOG("Cannot reroute edge during split"));
+            rollback(i);
+            return G::KEY_UNDEF;
+        }
+        if (g.add_edge(0, preds[i], new_key) == G::KEY_UNDEF) {
+            OPT(LOG("Cannot reroute edge during split"));
+            g.add_edge(0, preds[i], bb_key);
+            rollback(i);
+            return G::KEY_UNDEF;
+        }
+    }
+    if (g.add_edge(0, new_key, bb_key) == G::KEY_UNDEF) {
+        OPT(LOG("Cannot link split block"));
+        rollback(preds.size());
+        return G::KEY_UNDEF;
+    }
+
+    // single value dominates the new block as well; several ones are merged there
+    for (auto &flow : flows) {
+        if (flow.moved.size() < 2) {
+            continue;
+        }
+        auto *merged = instrs.create();
+        new_bb->push_phys({merged});
+        for (auto *input : flow.moved) {
+            merged->push_input(input);
+            if (std::find(flow.kept.begin(), flow.kept.end(), input) == flow.kept.end()) {
+                flow.phy->erase_input(input->bb()->get_id(), input->get_id());
+            }
+        }
+        flow.phy->push_input(merged);
+    }
+    return new_key;
+}
+
+/*
+Loop simplify algo, for every reducible loop:
+    1) preheader: preds of header outside of loop are routed through a new block
+    2) single latch: back edges are routed through a new block
+    3) dedicated exits: exit block w/ preds outside of loop gets a new block for loop preds
+    Phy inputs are matched to incoming edges by dominance (closest dominating input).
+    New blocks come from bbs, new phys from instrs. Header of the whole CFG gets no preheader.
+    Returns false if some split failed; that loop is left as is & the rest are still processed.
+*/
+bool doLoopSimplify(IR::BbGraph &g, IR::BasicBlockManager &bbs, IR::InstrManager &instrs) {
+    bool done{true};
+    std::vector<G::key_t> headers{};
+    for (auto it = g.nodes_begin(); it != g.nodes_end(); ++it) {
+        if (g.loop_header(it->first) == it->first) {
+            headers.push_back(it->first);
+        }
+    }
+    for (auto header : headers) {
+        if (g.is_irreducible_loop(header)) {
+            continue;
+        }
+        auto latches = g.latches(header);
+        if (g.preheader(header) == G::KEY_UNDEF) {
+            std::vector<G::key_t> outside{};
+            auto *node = g.at(header);
+            for (auto it = node->predecessors_begin(); it != node->predecessors_end(); ++it) {
+                if (std::find(latches.begin(), latches.end(), it->first) == latches.end()) {
+                    outside.push_back(it->first);
+                }
+            }
+            if (!outside.empty() &&
+                splitPredecessors(g, header, outside, bbs, instrs) == G::KEY_UNDEF) {
+                done = false;
+                continue;
+            }
+        }
+        if (latches.size() > 1 &&
+            splitPredecessors(g, header, latches, bbs, instrs) == G::KEY_UNDEF) {
+            done = false;
+            continue;
+        }
+
+        // exits grouped by outside block; nested loop exits are exits here too
+        auto exits = g.loop_exits(header);
+        std::sort(exits.begin(), exits.end(),
+                  [](const G::EdgeEndsT &a, const G::EdgeEndsT &b) { return a.second < b.second; });
+        for (size_t i = 0; i < exits.size();) {
+            G::key_t target = exits[i].second;
+            std::vector<G::key_t> inside{};
+            for (; i < exits.size() && exits[i].second == target; ++i) {
+                inside.push_back(exits[i].first);
+            }
+            if (g.at(target)->get_predecessor_count() != inside.size() &&
+                splitPredecessors(g, target, inside, bbs, instrs) == G::KEY_UNDEF) {
+                done = false;
+            }
+        }
+    }
+    return done;
+}
@@ -1,6 +1,8 @@
 #pragma once
+#include "arena.hpp"
 #include "basicblock.hpp"
 #include "instruction.hpp"
+#include <algorithm>
 #include <exception>
 #include <set>
 #include <vector>
@@ -12,14 +14,16 @@ class InstrManager {
     InstrManager(const InstrManager &) = delete;
     InstrManager(InstrManager &&) = delete;
     InstrManager() = default;
+    explicit InstrManager(Arena::ChunkSource source) : m_arena(source) {}
     void print() {
         for (auto *i : m_mem) {
             std::cout << i->get_id() << std::endl;
         }
     }
+    // instrs live in arena: run destructors (spilled operands), then drop chunks at once
     ~InstrManager() {
         for (auto i : m_mem) {
-            delete i;
+            i->~InstrBase();
         }
     }
 
@@ -59,10 +63,11 @@ class InstrManager {
 
         id_t id0 = (id == -1) ? m_id : id;
 
-        Instr *ptr = new Instr(id0, type, group, value);
+        Instr *ptr = m_arena.create<Instr>(id0, type, group, value);
 
         m_id = std::max(m_id, id0) + 1;
         m_mem.push_back(ptr);
+        index_(ptr);
 
         return ptr;
     }
@@ -70,10 +75,11 @@ class InstrManager {
     Phy *create(id_t id = -1) {
         id_t id0 = id == -1 ? m_id : id;
 
-        Phy *ptr = new Phy(id0);
+        Phy *ptr = m_arena.create<Phy>(id0);
 
         m_id = std::max(m_id, id0) + 1;
         m_mem.push_back(ptr);
+        index_(ptr);
 
         return ptr;
     }
@@ -92,24 +98,56 @@ class InstrManager {
         }
     }
 
+    /// @brief instr by id; O(1), nullptr if unknown
+    InstrBase *get(id_t id) const {
+        if (id <= ID_UNDEF || static_cast<size_t>(id) >= m_index.size()) {
+            return nullptr;
+        }
+        return m_index[id];
+    }
+    /// @brief bb currently holding instr; nullptr if instr is detached or unknown
+    BasicBlock *get_bb(id_t id) const {
+        auto *instr = get(id);
+        return instr ? instr->bb() : nullptr;
+    }
+
+  private:
+    // ids are handed out densely, so the index is a plain vector
+    void index_(InstrBase *instr) {
+        id_t id = instr->get_id();
+        if (id <= ID_UNDEF) {
+            return;
+        }
+        if (static_cast<size_t>(id) >= m_index.size()) {
+            m_index.resize(std::max(static_cast<size_t>(id) + 1, 2 * m_index.size()), nullptr);
+        }
+        m_index[id] = instr;
+    }
+
   private:
+    Arena m_arena{};
     std::vector<InstrBase *> m_mem{};
+    // id -> instr; bb is not stored: push/cut/erase keep instr->bb() current
+    std::vector<InstrBase *> m_index{};
     id_t m_id{1};
 };
 
 class BasicBlockManager {
   public:
     BasicBlockManager() = default;
+    explicit BasicBlockManager(Arena::ChunkSource source) : m_arena(source) {}
+    BasicBlockManager(const BasicBlockManager &) = delete;
+    BasicBlockManager(BasicBlockManager &&) = delete;
     ~BasicBlockManager() {
         for (auto i : m_mem) {
-            delete i;
+            i->~BasicBlock();
         }
     }
 
     BasicBlock *create(id_t id = -1) {
         id_t id0 = id == -1 ? m_id : id;
 
-        BasicBlock *ptr = new BasicBlock(id0);
+        BasicBlock *ptr = m_arena.create<BasicBlock>(id0);
 
         m_id = std::max(m_id, id0) + 1;
         m_mem.push_back(ptr);
@@ -131,6 +169,7 @@ class BasicBlockManager {
     }
 
   private:
+    Arena m_arena{};
     std::vector<BasicBlock *> m_mem{};
     id_t m_id{1};
 };
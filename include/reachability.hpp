@@ -0,0 +1,48 @@
+#pragma once
+#include "config.hpp"
+#include "csrGraph.hpp"
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace G {
+
+/// @brief reachability index over densely indexed nodes, answers many queries per graph version
+/// strongly connected components are collapsed first; a small condensation gets a bitset
+/// transitive closure (O(1) query), a large one gets interval lists over DFS post numbers of
+/// the condensation (O(log n) query, size depends on how far the DAG is from a tree)
+class Reachability {
+  public:
+    /// @brief condensations up to this size get a bitset closure
+    static constexpr idx_t BITSET_LIMIT = 4096;
+
+    Reachability() = default;
+
+    void build(const CsrGraph &g, idx_t bitset_limit = BITSET_LIMIT);
+    void clear();
+
+    size_t size() const;
+    bool is_bitset() const;
+    /// @return component id of CsrGraph::SCC; IDX_UNDEF for wrong index
+    idx_t component(idx_t node) const;
+    /// @return true if end is reachable from start (a node reaches itself)
+    bool reaches(idx_t start, idx_t end) const;
+
+  private:
+    void build_bitset_(const CsrGraph &dag);
+    void build_intervals_(const CsrGraph &dag);
+
+    std::vector<idx_t> m_component{};
+    idx_t m_count{0};
+    bool m_bitset{false};
+    // closure rows of m_words words each, row by component id
+    size_t m_words{0};
+    std::vector<uint64_t> m_rows{};
+    // post number of component & intervals of post numbers it reaches:
+    // m_intervals[m_interval_begin[c]..[c + 1]), sorted & disjoint
+    std::vector<idx_t> m_post{};
+    std::vector<idx_t> m_interval_begin{};
+    std::vector<std::pair<idx_t, idx_t>> m_intervals{};
+};
+
+} // namespace G
@@ -0,0 +1,157 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+
+namespace G {
+
+/// @brief vector keeping up to InlineN elements inside the object, spills to heap beyond that
+/// T must be default constructible & copy assignable
+template <typename T, size_t InlineN> class SmallVector {
+  public:
+    using iterator = T *;
+    using const_iterator = const T *;
+
+    SmallVector() = default;
+    SmallVector(const SmallVector &other);
+    SmallVector(SmallVector &&other);
+    SmallVector &operator=(const SmallVector &other);
+    SmallVector &operator=(SmallVector &&other);
+    ~SmallVector();
+
+    iterator begin() { return m_data; }
+    iterator end() { return m_data + m_size; }
+    const_iterator begin() const { return m_data; }
+    const_iterator end() const { return m_data + m_size; }
+    size_t size() const { return m_size; }
+    size_t capacity() const { return m_capacity; }
+    bool empty() const { return m_size == 0; }
+    bool is_inline() const { return m_data == m_inline; }
+    T &operator[](size_t i) { return m_data[i]; }
+    const T &operator[](size_t i) const { return m_data[i]; }
+    T &back() { return m_data[m_size - 1]; }
+    const T &back() const { return m_data[m_size - 1]; }
+
+    void reserve(size_t capacity);
+    void push_back(const T &value);
+    void pop_back() { --m_size; }
+    /// @brief shifts tail right; returns iterator to the inserted element
+    iterator insert(iterator pos, const T &value);
+    /// @brief shifts tail left; returns iterator to the element after erased one
+    iterator erase(iterator pos);
+    void clear() { m_size = 0; }
+
+  private:
+    // this must be empty & inline
+    void steal_(SmallVector &other);
+
+  private:
+    T m_inline[InlineN]{};
+    T *m_data{m_inline};
+    size_t m_size{0};
+    size_t m_capacity{InlineN};
+};
+
+template <typename T, size_t InlineN>
+SmallVector<T, InlineN>::SmallVector(const SmallVector &other) {
+    reserve(other.m_size);
+    std::copy(other.begin(), other.end(), m_data);
+    m_size = other.m_size;
+}
+
+template <typename T, size_t InlineN> SmallVector<T, InlineN>::SmallVector(SmallVector &&other) {
+    steal_(other);
+}
+
+template <typename T, size_t InlineN> void SmallVector<T, InlineN>::steal_(SmallVector &other) {
+    if (other.is_inline()) {
+        std::copy(other.begin(), other.end(), m_data);
+    } else {
+        // steal heap buffer
+        m_data = other.m_data;
+        m_capacity = other.m_capacity;
+        other.m_data = other.m_inline;
+        other.m_capacity = InlineN;
+    }
+    m_size = other.m_size;
+    other.m_size = 0;
+}
+
+template <typename T, size_t InlineN>
+SmallVector<T, InlineN> &SmallVector<T, InlineN>::operator=(const SmallVector &other) {
+    if (this == &other) {
+        return *this;
+    }
+    m_size = 0;
+    reserve(other.m_size);
+    std::copy(other.begin(), other.end(), m_data);
+    m_size = other.m_size;
+    return *this;
+}
+
+template <typename T, size_t InlineN>
+SmallVector<T, InlineN> &SmallVector<T, InlineN>::operator=(SmallVector &&other) {
+    if (this == &other) {
+        return *this;
+    }
+    if (!is_inline()) {
+        delete[] m_data;
+    }
+    m_data = m_inline;
+    m_capacity = InlineN;
+    m_size = 0;
+    steal_(other);
+    return *this;
+}
+
+template <typename T, size_t InlineN> SmallVector<T, InlineN>::~SmallVector() {
+    if (!is_inline()) {
+        delete[] m_data;
+    }
+}
+
+template <typename T, size_t InlineN> void SmallVector<T, InlineN>::reserve(size_t capacity) {
+    if (capacity <= m_capacity) {
+        return;
+    }
+    T *data = new T[capacity];
+    std::copy(begin(), end(), data);
+    if (!is_inline()) {
+        delete[] m_data;
+    }
+    m_data = data;
+    m_capacity = capacity;
+}
+
+template <typename T, size_t InlineN> void SmallVector<T, InlineN>::push_back(const T &value) {
+    if (m_size == m_capacity) {
+        T copy = value; // value may live in this buffer
+        reserve(2 * m_capacity);
+        m_data[m_size++] = copy;
+        return;
+    }
+    m_data[m_size++] = value;
+}
+
+template <typename T, size_t InlineN>
+typename SmallVector<T, InlineN>::iterator SmallVector<T, InlineN>::insert(iterator pos,
+                                                                          const T &value) {
+    size_t idx = pos - m_data;
+    T copy = value;
+    if (m_size == m_capacity) {
+        reserve(2 * m_capacity);
+    }
+    std::copy_backward(m_data + idx, m_data + m_size, m_data + m_size + 1);
+    m_data[idx] = copy;
+    ++m_size;
+    return m_data + idx;
+}
+
+template <typename T, size_t InlineN>
+typename SmallVector<T, InlineN>::iterator SmallVector<T, InlineN>::erase(iterator pos) {
+    std::copy(pos + 1, end(), pos);
+    --m_size;
+    return pos;
+}
+
+} // namespace G
@@ -1,64 +1,41 @@
 #include "LoopTreeBuilder.hpp"
 
 namespace Analysis {
-template <> void buildLoopTree(G::Graph<int, int> *g, G::Graph<G::Cycle, int> *loops) {
-    if (g == nullptr || loops == nullptr) {
+void buildLoopTree(const G::CsrGraph &view, const G::LoopForest &forest,
+                   G::Graph<G::Cycle, int> *loops, std::vector<G::Cycle> &cycles,
+                   G::key_t root_loop_key) {
+    if (loops == nullptr) {
         return;
     }
-    // create loop nodes
-    auto v = g->get_cycles(1, -1);
-    for (auto &cycle : v) {
-        OPT(std::cout << cycle.dump() << std::endl;);
-        loops->add_node(cycle, cycle.back_edge_start);
-    }
-
-    // generate RPO round
-    auto rpo = g->RPO(1);
-#ifndef NDEBUG_DEV
-    std::cout << "RPO: ";
-    for (auto elem : rpo) {
-        std::cout << elem << "\t";
-    }
-    std::cout << "\n";
-    auto dfs = g->DFS(1);
-    std::cout << "DFS: ";
-    for (auto elem : dfs) {
-        std::cout << elem << "\t";
-    }
-    std::cout << "\n";
-#endif
-
-    // populate loops
-    for (auto it = rpo.rbegin(), rend = rpo.rend(); it != rend; ++it) {
-        if (!loops->node_exists(*it) /*|| !loops.at(*it)->data().reducible*/) {
-            continue;
-        }
-        auto current_loop = *it;
-        OPT(LOGarg("Work with loop", current_loop));
-        // link inner loops
-        for (auto key : g->DFS(loops->at(current_loop)->data().back_edge_start)) {
-            OPT(LOGarg("\tfound block:", key));
-            if (g->at(key)->get_loop() == G::KEY_UNDEF) {
-                g->at(key)->set_loop(current_loop);
-            } else {
-                auto outer_loop = g->at(key)->get_loop();
-                g->at(key)->set_loop(current_loop);
-                OPT(std::cout << "Adding edge" << outer_loop << " -> " << current_loop << std::endl;);
-                loops->add_edge(0, outer_loop, current_loop);
+    // nodes keep references into cycles, so no reallocation after this point
+    cycles.clear();
+    cycles.reserve(forest.headers().size() + 1);
+    cycles.emplace_back();
+    loops->add_node(cycles.back(), root_loop_key);
+    // create loop nodes; headers come in preorder, so outer loops already exist
+    for (auto header : forest.headers()) {
+        G::idx_t latch = forest.back_edge_start(header);
+        G::key_t back_edge{G::KEY_UNDEF};
+        for (auto *it = view.successors_begin(latch); it != view.successors_end(latch); ++it) {
+            if (*it == header) {
+                back_edge = view.out_edges_begin(latch)[it - view.successors_begin(latch)];
+                break;
             }
         }
+        G::key_t key = view.key(header);
+        cycles.emplace_back(key, back_edge, view.key(latch), !forest.is_irreducible(header));
+        OPT(std::cout << cycles.back().dump() << std::endl;);
+        loops->add_node(cycles.back(), key);
+        G::idx_t parent = forest.parent(header);
+        loops->add_edge(0, parent == G::IDX_UNDEF ? root_loop_key : view.key(parent), key);
     }
 
-    for (auto it = g->nodes_begin(); it != g->nodes_end(); ++it) {
-        if (it->second->get_loop() == G::KEY_UNDEF) {
-            key_t root_loop_key = g->get_node_count() + 1;
-            auto cycle = G::Cycle{};
-            loops->add_node(cycle, root_loop_key);
-            loops->at(root_loop_key)->data().blocks.push_back(it->second->get_key());
-        } else {
-            ASSERT_DEV(loops->at(it->second->get_loop()) != nullptr, "Wrong loop node");
-            loops->at(it->second->get_loop())->data().blocks.push_back(it->second->get_key());
-        }
+    // populate loops w/ blocks of innermost loop
+    for (G::idx_t node = 0; node < view.size(); ++node) {
+        G::idx_t header = forest.loop(node);
+        G::key_t loop_key = (header == G::IDX_UNDEF) ? root_loop_key : view.key(header);
+        ASSERT_DEV(loops->at(loop_key) != nullptr, "Wrong loop node");
+        loops->at(loop_key)->data().blocks.push_back(view.key(node));
     }
 }
-} // namespace Analysis
\ No newline at end of file
+} // namespace Analysis
@@ -0,0 +1,84 @@
+#include "arena.hpp"
+#include <algorithm>
+#include <cstdint>
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+namespace IR {
+
+Arena::Arena(ChunkSource source, size_t chunk_size)
+    : m_source(source), m_chunk_size(std::max(chunk_size, size_t{4096})) {}
+
+Arena::~Arena() { release(); }
+
+Arena::ChunkSource Arena::source() const { return m_source; }
+size_t Arena::chunk_count() const { return m_chunks.size(); }
+size_t Arena::bytes_used() const { return m_used; }
+
+void *Arena::allocate(size_t size, size_t align) {
+    auto aligned = [align](char *ptr) {
+        auto addr = reinterpret_cast<uintptr_t>(ptr);
+        return reinterpret_cast<char *>((addr + align - 1) & ~(uintptr_t{align} - 1));
+    };
+    char *ptr = m_cur ? aligned(m_cur) : nullptr;
+    if (!ptr || ptr + size > m_end) {
+        // oversized objects get a chunk of their own; the current one stays open
+        if (size + align > m_chunk_size) {
+            Chunk chunk = allocate_chunk_(size + align);
+            m_chunks.push_back(chunk);
+            m_used += size;
+            return aligned(chunk.data);
+        }
+        Chunk chunk = allocate_chunk_(m_chunk_size);
+        m_chunks.push_back(chunk);
+        m_cur = chunk.data;
+        m_end = chunk.data + chunk.size;
+        ptr = aligned(m_cur);
+    }
+    m_used += (ptr - m_cur) + size;
+    m_cur = ptr + size;
+    return ptr;
+}
+
+void Arena::release() {
+    for (auto &chunk : m_chunks) {
+        free_chunk_(chunk);
+    }
+    m_chunks.clear();
+    m_cur = nullptr;
+    m_end = nullptr;
+    m_used = 0;
+}
+
+Arena::Chunk Arena::allocate_chunk_(size_t size) {
+#ifdef __linux__
+    if (m_source == ChunkSource::HUGE_PAGES) {
+        size = (size + CHUNK_SIZE - 1) / CHUNK_SIZE * CHUNK_SIZE;
+        void *ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (ptr == MAP_FAILED) {
+            // no reserved huge pages: ask for transparent ones
+            ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (ptr == MAP_FAILED) {
+                throw std::bad_alloc();
+            }
+            madvise(ptr, size, MADV_HUGEPAGE);
+        }
+        return {static_cast<char *>(ptr), size, true};
+    }
+#endif
+    return {static_cast<char *>(::operator new(size)), size, false};
+}
+
+void Arena::free_chunk_(const Chunk &chunk) {
+#ifdef __linux__
+    if (chunk.mapped) {
+        munmap(chunk.data, chunk.size);
+        return;
+    }
+#endif
+    ::operator delete(chunk.data);
+}
+
+} // namespace IR
@@ -4,10 +4,45 @@
 #include <set>
 namespace IR {
 
+namespace {
+// attach instr before pos (pos == nullptr: at end)
+template <typename T> void link_before(T *&first, T *&last, T *pos, T *instr) {
+    T *prev = pos ? static_cast<T *>(pos->prev()) : last;
+    instr->set_prev(prev);
+    instr->set_next(pos);
+    if (prev) {
+        prev->set_next(instr);
+    } else {
+        first = instr;
+    }
+    if (pos) {
+        pos->set_prev(instr);
+    } else {
+        last = instr;
+    }
+}
+
+template <typename T> void unlink(T *&first, T *&last, T *instr) {
+    auto *prev = static_cast<T *>(instr->prev());
+    auto *next = static_cast<T *>(instr->next());
+    if (prev) {
+        prev->set_next(next);
+    } else {
+        first = next;
+    }
+    if (next) {
+        next->set_prev(prev);
+    } else {
+        last = prev;
+    }
+    instr->set_prev(nullptr);
+    instr->set_next(nullptr);
+}
+} // namespace
+
 BasicBlock::BasicBlock() {}
 BasicBlock::BasicBlock(id_t id) : m_bb_id(id) {}
 BasicBlock::BasicBlock(id_t id, InstrInitList instrs, PhyInitList phys) : m_bb_id(id) {
-    Instr *prev{nullptr};
     std::set<key_t> instrIds{};
     for (auto *instr : instrs) {
         ASSERT_DEV(instr, "nullptr during bb fill");
@@ -16,71 +51,52 @@ BasicBlock::BasicBlock(id_t id, InstrInitList instrs, PhyInitList phys) : m_bb_i
         }
         instr->set_bb(this);
         instr->throwIfNotConsistent_();
-        instr->set_prev(prev);
-        m_instrs.push_back(instr);
-        prev = instr;
+        link_before(m_instr_first, m_instr_last, static_cast<Instr *>(nullptr), instr);
+        ++m_instr_count;
     }
 
-    Phy *prevPhy{nullptr};
     for (auto *phy : phys) {
         ASSERT_DEV(phy, "nullptr during bb fill");
         phy->set_bb(this);
         phy->throwIfNotConsistent_();
-        phy->set_prev(prevPhy);
-        m_phys.push_back(phy);
-        prevPhy = phy;
+        link_before(m_phy_first, m_phy_last, static_cast<Phy *>(nullptr), phy);
+        ++m_phy_count;
     }
 }
 
-BasicBlock::BasicBlock(BasicBlock &&bb) {
-    for (auto *ptr : bb.m_instrs) {
-        m_instrs.push_back(ptr);
+BasicBlock::BasicBlock(BasicBlock &&bb)
+    : m_bb_id(bb.m_bb_id), m_phy_first(bb.m_phy_first), m_phy_last(bb.m_phy_last),
+      m_phy_count(bb.m_phy_count), m_instr_first(bb.m_instr_first),
+      m_instr_last(bb.m_instr_last), m_instr_count(bb.m_instr_count) {
+    for (auto it = phy_begin(); it != phy_end(); ++it) {
+        (*it)->set_bb(this);
     }
-    bb.m_instrs.clear();
-    for (auto *ptr : bb.m_phys) {
-        m_phys.push_back(ptr);
+    for (auto it = instr_begin(); it != instr_end(); ++it) {
+        (*it)->set_bb(this);
     }
-    bb.m_phys.clear();
+    bb.m_phy_first = bb.m_phy_last = nullptr;
+    bb.m_instr_first = bb.m_instr_last = nullptr;
+    bb.m_phy_count = bb.m_instr_count = 0;
 }
 
 id_t BasicBlock::get_id() const { return m_bb_id; }
-BasicBlock::InstrCIt BasicBlock::instr_cbegin() const { return m_instrs.cbegin(); }
-BasicBlock::InstrCIt BasicBlock::instr_cend() const { return m_instrs.cend(); }
-BasicBlock::PhyCIt BasicBlock::phy_cbegin() const { return m_phys.cbegin(); }
-BasicBlock::PhyCIt BasicBlock::phy_cend() const { return m_phys.cend(); }
-BasicBlock::InstrIt BasicBlock::instr_begin() { return m_instrs.begin(); }
-BasicBlock::InstrIt BasicBlock::instr_end() { return m_instrs.end(); }
-BasicBlock::PhyIt BasicBlock::phy_begin() { return m_phys.begin(); }
-BasicBlock::PhyIt BasicBlock::phy_end() { return m_phys.end(); }
-
-BasicBlock::InstrCIt BasicBlock::instr_clast() const {
-    if (m_instrs.size() == 0) {
-        return m_instrs.cend();
-    }
-    return --m_instrs.cend();
-}
-BasicBlock::InstrIt BasicBlock::instr_last() {
-    if (m_instrs.size() == 0) {
-        return m_instrs.end();
-    }
-    return --m_instrs.end();
-}
-
-BasicBlock::PhyCIt BasicBlock::phy_clast() const {
-    if (m_phys.size() == 0) {
-        return m_phys.cend();
-    }
-    return --m_phys.cend();
-}
-BasicBlock::PhyIt BasicBlock::phy_last() {
-    if (m_phys.size() == 0) {
-        return m_phys.end();
-    }
-    return --m_phys.end();
-}
+BasicBlock::InstrCIt BasicBlock::instr_cbegin() const { return {m_instr_first, &m_instr_last}; }
+BasicBlock::InstrCIt BasicBlock::instr_cend() const { return {nullptr, &m_instr_last}; }
+BasicBlock::PhyCIt BasicBlock::phy_cbegin() const { return {m_phy_first, &m_phy_last}; }
+BasicBlock::PhyCIt BasicBlock::phy_cend() const { return {nullptr, &m_phy_last}; }
+BasicBlock::InstrIt BasicBlock::instr_begin() { return {m_instr_first, &m_instr_last}; }
+BasicBlock::InstrIt BasicBlock::instr_end() { return {nullptr, &m_instr_last}; }
+BasicBlock::PhyIt BasicBlock::phy_begin() { return {m_phy_first, &m_phy_last}; }
+BasicBlock::PhyIt BasicBlock::phy_end() { return {nullptr, &m_phy_last}; }
+BasicBlock::InstrCIt BasicBlock::instr_clast() const { return {m_instr_last, &m_instr_last}; }
+BasicBlock::InstrIt BasicBlock::instr_last() { return {m_instr_last, &m_instr_last}; }
+BasicBlock::PhyCIt BasicBlock::phy_clast() const { return {m_phy_last, &m_phy_last}; }
+BasicBlock::PhyIt BasicBlock::phy_last() { return {m_phy_last, &m_phy_last}; }
+size_t BasicBlock::instr_count() const { return m_instr_count; }
+size_t BasicBlock::phy_count() const { return m_phy_count; }
 
 void BasicBlock::push_instrs(InstrInitList list) {
-    Instr *prev = m_instrs.size() ? *instr_clast() : nullptr;
+    size_t order = m_instr_last ? m_instr_last->order() + 1 : m_phy_count;
     std::set<key_t> instrIds{};
 
     for (auto *instr : list) {
@@ -93,30 +109,136 @@ void BasicBlock::push_instrs(InstrInitList list) {
             throw std::logic_error("Instr has already been attached to bb");
         }
         instr->set_bb(this);
-        instr->set_prev(prev);
-        instr->set_next(nullptr);
-        if (prev) {
-            prev->set_next(instr);
-        }
-        m_instrs.push_back(instr);
-        prev = instr;
+        instr->set_order(order++);
+        link_before(m_instr_first, m_instr_last, static_cast<Instr *>(nullptr), instr);
+        ++m_instr_count;
     }
 }
 
 void BasicBlock::push_phys(BasicBlock::PhyInitList list) {
-    Phy *prev = m_phys.size() ? *phy_clast() : nullptr;
     for (auto *phy : list) {
         ASSERT_DEV(phy, "nullptr during bb fill");
         phy->throwIfNotConsistent_();
-        m_phys.push_back(phy);
+        phy->set_bb(this);
+        link_before(m_phy_first, m_phy_last, static_cast<Phy *>(nullptr), phy);
+        ++m_phy_count;
+    }
+    m_order_valid = false;
+}
+
+BasicBlock::InstrIt BasicBlock::insert_before(Instr *pos, Instr *instr) {
+    ASSERT_DEV(instr, "nullptr during bb fill");
+    instr->throwIfNotConsistent_();
+    if (instr->bb() != nullptr) {
+        throw std::logic_error("Instr has already been attached to bb");
+    }
+    if (pos && pos->bb() != this) {
+        throw std::logic_error("Position is out of bb");
+    }
+    instr->set_bb(this);
+    link_before(m_instr_first, m_instr_last, pos, instr);
+    ++m_instr_count;
+    m_order_valid = false;
+    return {instr, &m_instr_last};
+}
+
+BasicBlock::InstrIt BasicBlock::insert_after(Instr *pos, Instr *instr) {
+    if (pos && pos->bb() != this) {
+        throw std::logic_error("Position is out of bb");
+    }
+    return insert_before(pos ? static_cast<Instr *>(pos->next()) : m_instr_first, instr);
+}
+
+BasicBlock::InstrIt BasicBlock::unlink_instr(Instr *instr) {
+    if (!instr || instr->bb() != this) {
+        return instr_end();
     }
+    auto *next = static_cast<Instr *>(instr->next());
+    unlink(m_instr_first, m_instr_last, instr);
+    instr->set_bb(nullptr);
+    --m_instr_count;
+    return {next, &m_instr_last};
+}
+
+void BasicBlock::splice(Instr *pos, BasicBlock &other, Instr *first, Instr *last) {
+    if (&other == this) {
+        throw std::logic_error("Splice inside the same bb");
+    }
+    if (pos && pos->bb() != this) {
+        throw std::logic_error("Position is out of bb");
+    }
+    if (!first || !last || first->bb() != &other || last->bb() != &other) {
+        throw std::logic_error("Range is out of bb");
+    }
+    size_t count{1};
+    for (auto *instr = first; instr != last; ++count) {
+        instr = static_cast<Instr *>(instr->next());
+        if (!instr) {
+            throw std::logic_error("Wrong range");
+        }
+    }
+    // cut [first, last] out of other
+    auto *before = static_cast<Instr *>(first->prev());
+    auto *after = static_cast<Instr *>(last->next());
+    if (before) {
+        before->set_next(after);
+    } else {
+        other.m_instr_first = after;
+    }
+    if (after) {
+        after->set_prev(before);
+    } else {
+        other.m_instr_last = before;
+    }
+    other.m_instr_count -= count;
+    // and put it before pos
+    auto *prev = pos ? static_cast<Instr *>(pos->prev()) : m_instr_last;
+    first->set_prev(prev);
+    last->set_next(pos);
+    if (prev) {
+        prev->set_next(first);
+    } else {
+        m_instr_first = first;
+    }
+    if (pos) {
+        pos->set_prev(last);
+    } else {
+        m_instr_last = last;
+    }
+    m_instr_count += count;
+    for (auto *instr = first; instr != pos; instr = static_cast<Instr *>(instr->next())) {
+        instr->set_bb(this);
+    }
+    m_order_valid = false;
+}
+
+bool BasicBlock::is_before(const InstrBase *a, const InstrBase *b) {
+    if (!a || !b || a->bb() != this || b->bb() != this) {
+        return false;
+    }
+    if (!m_order_valid) {
+        renumber_();
+    }
+    return a->order() < b->order();
+}
+
+void BasicBlock::renumber_() {
+    size_t order{0};
+    for (auto it = phy_cbegin(); it != phy_cend(); ++it) {
+        (*it)->set_order(order++);
+    }
+    for (auto it = instr_cbegin(); it != instr_cend(); ++it) {
+        (*it)->set_order(order++);
+    }
+    m_order_valid = true;
 }
 
 void BasicBlock::throwIfNotConsistent_() const {
-    const Instr *current_instr = *m_instrs.begin();
     const Instr *prev_instr{nullptr};
+    size_t count{0};
     std::set<key_t> instrIds{};
-    for (const auto *i : m_instrs) {
+    for (auto it = instr_cbegin(); it != instr_cend(); ++it) {
+        const auto *i = *it;
         ASSERT_DEV(i, "nullptr instr in bb");
         i->throwIfNotConsistent_();
         i->throwIfWrongInputCount_();
@@ -130,6 +252,14 @@ void BasicBlock::throwIfNotConsistent_() const {
         if (!instrIds.insert(i->get_id()).second) {
             throw std::logic_error("instr id dublicate");
         }
+        if (i->prev() != prev_instr) {
+            throw std::logic_error("broken instr list");
+        }
+        prev_instr = i;
+        ++count;
+    }
+    if (prev_instr != m_instr_last || count != m_instr_count) {
+        throw std::logic_error("broken instr list");
     }
 }
 
@@ -139,13 +269,13 @@ std::vector<std::string> BasicBlock::dump_() const {
     strs.push_back(bb_header);
 
     strs.push_back("--- Phys ---");
-    for (const auto *phy : m_phys) {
-        strs.push_back(phy->dump());
+    for (auto it = phy_cbegin(); it != phy_cend(); ++it) {
+        strs.push_back((*it)->dump());
     }
 
     strs.push_back("--- Instrs ---");
-    for (const auto *instr : m_instrs) {
-        strs.push_back(instr->dump());
+    for (auto it = instr_cbegin(); it != instr_cend(); ++it) {
+        strs.push_back((*it)->dump());
     }
     return strs;
 }
@@ -165,42 +295,33 @@ id_t BasicBlock::set_id(id_t id) {
 }
 
 BasicBlock::InstrIt BasicBlock::erase_instr(InstrIt it) {
-    if (it == m_instrs.end()) {
-        return m_instrs.end();
+    if (it == instr_end()) {
+        return instr_end();
     }
     auto *instr = *it;
-    // clear user list of all inputs
-    for (auto inputTt = instr->inputs_begin(); inputTt != instr->inputs_end(); ++inputTt) {
-        auto *input = *inputTt;
-        input->users().remove(instr);
-        // ASSERT_DEV(count == 1, "Dublicates in input users");
-    }
-    // clear input list of all users
-    for (auto userTt = instr->users_begin(); userTt != instr->users_end(); ++userTt) {
-        auto *user = *userTt;
-        user->inputs().remove(instr);
-        // ASSERT_DEV(count == 1, "Dublicates in input users");
-    }
+    // leave use-lists of inputs, then vanish from operands of users
+    instr->drop_inputs();
+    instr->drop_users();
+    return unlink_instr(instr);
+}
 
-    // clear cfg
-    auto *next = instr->next();
-    auto *prev = instr->prev();
-    if (next) {
-        next->set_prev(prev);
+BasicBlock::InstrIt BasicBlock::erase_instr(Instr *instr) {
+    if (!instr || instr->bb() != this) {
+        return instr_end();
     }
-    if (prev) {
-        prev->set_next(next);
-    }
-    instr->set_next(nullptr);
-    instr->set_prev(nullptr);
-    instr->set_bb(nullptr);
+    return erase_instr(InstrIt{instr, &m_instr_last});
+}
 
-    InstrIt nextIt = m_instrs.erase(it);
-    return nextIt;
+bool BasicBlock::erase_unused_instr(Instr *instr) {
+    if (!instr || instr->bb() != this || instr->user_count() != 0) {
+        return false;
+    }
+    erase_instr(instr);
+    return true;
 }
 
 id_t BasicBlock::erase_instr(id_t key) {
-    for (auto it = m_instrs.begin(); it != m_instrs.end(); ++it) {
+    for (auto it = instr_begin(); it != instr_end(); ++it) {
         auto* instr = *it;
         if (instr->get_id() == key) {
             erase_instr(it);
@@ -211,9 +332,9 @@ id_t BasicBlock::erase_instr(id_t key) {
 }
 
 id_t BasicBlock::erase_unused_instr(id_t key) {
-    for (auto it = m_instrs.begin(); it != m_instrs.end(); ++it) {
+    for (auto it = instr_begin(); it != instr_end(); ++it) {
         auto* instr = *it;
-        if (instr->get_id() == key && instr->users().size() == 0) {
+        if (instr->get_id() == key && instr->user_count() == 0) {
             erase_instr(it);
             return key;
         }
@@ -222,49 +343,41 @@ id_t BasicBlock::erase_unused_instr(id_t key) {
 }
 
 std::pair<BasicBlock::InstrIt, Instr *> BasicBlock::cut_instr(id_t key) {
-    auto it = m_instrs.begin();
-    while (it != m_instrs.end()) {
+    for (auto it = instr_begin(); it != instr_end(); ++it) {
         auto *instr = *it;
         if (instr->get_id() == key) {
-            auto *next = instr->next();
-            auto *prev = instr->prev();
-            if (next) {
-                next->set_prev(prev);
-            }
-            if (prev) {
-                prev->set_next(next);
-            }
-            instr->set_next(nullptr);
-            instr->set_prev(nullptr);
-            instr->set_bb(nullptr);
-            it = m_instrs.erase(it);
-            return {it, instr};
+            return {unlink_instr(instr), instr};
         }
-        ++it;
     }
-    return {m_instrs.end(), nullptr};
+    return {instr_end(), nullptr};
 }
 
 BasicBlock::PhyIt BasicBlock::erase_phy(PhyIt it) {
-    if (it == m_phys.end()) {
-        return m_phys.end();
+    if (it == phy_end()) {
+        return phy_end();
     }
-    PhyIt nextIt = m_phys.erase(it);
-    delete *it;
-    return nextIt;
+    // phys are owned by InstrManager: detach only
+    auto *phy = *it;
+    auto *next = static_cast<Phy *>(phy->next());
+    phy->drop_inputs();
+    phy->drop_users();
+    unlink(m_phy_first, m_phy_last, phy);
+    phy->set_bb(nullptr);
+    --m_phy_count;
+    return {next, &m_phy_last};
 }
 
 size_t BasicBlock::removeUnusedInstrs() {
-    auto it = m_instrs.begin();
+    auto it = instr_begin();
     auto count{0};
-    while(it != m_instrs.end()) {
+    while(it != instr_end()) {
         auto *instr = *it;
         if (instr->type() != IR::GroupType::GENERAL64) {
             ++it;
             continue;
         }
-        if (instr->users().size() == 0) {
-            it = m_instrs.erase(it);
+        if (instr->user_count() == 0) {
+            it = erase_instr(it);
             ++count;
         } else {
             ++it;
@@ -273,4 +386,4 @@ size_t BasicBlock::removeUnusedInstrs() {
     return count;
 }
 
-} // namespace IR
\ No newline at end of file
+} // namespace IR
@@ -20,6 +20,70 @@ G::key_t BbGraph::add_node(BasicBlock& data, id_t id) {
     return key;
 }
 
+G::KeyMapT BbGraph::compact() {
+    auto keys = Graph::compact();
+    if (keys.empty()) {
+        return keys;
+    }
+    for (auto &node : m_nodes) {
+        node.second->data().set_id(node.first);
+    }
+    if (m_headerBbKey != G::KEY_UNDEF) {
+        auto header = keys.find(m_headerBbKey);
+        m_headerBbKey = (header == keys.end()) ? G::KEY_UNDEF : header->second;
+    }
+    return keys;
+}
+
+bool BbGraph::instr_dominates(const InstrBase *a, const InstrBase *b) {
+    if (!a || !b || !a->bb() || !b->bb()) {
+        return false;
+    }
+    if (a == b) {
+        return true;
+    }
+    if (a->bb() == b->bb()) {
+        return a->bb()->is_before(a, b);
+    }
+    return is_a_dominates_b(m_headerBbKey, a->bb()->get_id(), b->bb()->get_id());
+}
+
+std::vector<G::key_t> BbGraph::dom_frontier(G::key_t bb_key) {
+    return get_dom_frontier(m_headerBbKey, bb_key);
+}
+
+G::key_t BbGraph::nearest_common_dominator(G::key_t a, G::key_t b) {
+    return get_nearest_common_dominator(m_headerBbKey, a, b);
+}
+
+std::vector<G::key_t> BbGraph::phi_blocks(const std::vector<G::key_t> &def_bbs) {
+    return get_iterated_dom_frontier(m_headerBbKey, def_bbs);
+}
+
+size_t BbGraph::loop_depth(G::key_t bb_key) {
+    return get_loop_depth(m_headerBbKey, bb_key);
+}
+
+G::key_t BbGraph::loop_header(G::key_t bb_key) {
+    return get_loop_header(m_headerBbKey, bb_key);
+}
+
+std::vector<G::key_t> BbGraph::latches(G::key_t loop_header_key) {
+    return get_latches(m_headerBbKey, loop_header_key);
+}
+
+std::vector<G::EdgeEndsT> BbGraph::loop_exits(G::key_t loop_header_key) {
+    return get_loop_exits(m_headerBbKey, loop_header_key);
+}
+
+G::key_t BbGraph::preheader(G::key_t loop_header_key) {
+    return get_preheader(m_headerBbKey, loop_header_key);
+}
+
+bool BbGraph::is_irreducible_loop(G::key_t loop_header_key) {
+    return is_loop_irreducible(m_headerBbKey, loop_header_key);
+}
+
 void BbGraph::throwIfNotConsistent() {
     if (m_nodes.size() == 0) {
         return;
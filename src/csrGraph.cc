@@ -0,0 +1,252 @@
+#include "csrGraph.hpp"
+#include <algorithm>
+
+namespace G {
+
+void CsrGraph::clear() {
+    m_keys.clear();
+    m_index.clear();
+    m_succ_begin.clear();
+    m_succs.clear();
+    m_succ_edges.clear();
+    m_pred_begin.clear();
+    m_preds.clear();
+    m_enter_mark.clear();
+    m_exit_mark.clear();
+}
+
+void CsrGraph::build(const std::vector<key_t> &node_keys, const std::vector<EdgeT> &edges) {
+    clear();
+    const size_t n = node_keys.size();
+    m_keys = node_keys;
+    m_index.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        m_index.emplace(m_keys[i], static_cast<idx_t>(i));
+    }
+    // ranges by counting sort; stable, so edges keep their given order
+    std::vector<std::pair<idx_t, idx_t>> ends{};
+    ends.reserve(edges.size());
+    m_succ_begin.assign(n + 1, 0);
+    m_pred_begin.assign(n + 1, 0);
+    for (auto &edge : edges) {
+        idx_t start = index(edge.start);
+        idx_t end = index(edge.end);
+        if (start == IDX_UNDEF || end == IDX_UNDEF) {
+            OPT(LOG("No start/end node - edge skipped"));
+            ends.emplace_back(IDX_UNDEF, IDX_UNDEF);
+            continue;
+        }
+        ends.emplace_back(start, end);
+        ++m_succ_begin[start + 1];
+        ++m_pred_begin[end + 1];
+    }
+    for (size_t i = 0; i < n; ++i) {
+        m_succ_begin[i + 1] += m_succ_begin[i];
+        m_pred_begin[i + 1] += m_pred_begin[i];
+    }
+    m_succs.assign(m_succ_begin[n], IDX_UNDEF);
+    m_succ_edges.assign(m_succ_begin[n], KEY_UNDEF);
+    m_preds.assign(m_pred_begin[n], IDX_UNDEF);
+    std::vector<idx_t> succ_fill(m_succ_begin.begin(), m_succ_begin.end() - 1);
+    std::vector<idx_t> pred_fill(m_pred_begin.begin(), m_pred_begin.end() - 1);
+    for (size_t i = 0; i < edges.size(); ++i) {
+        idx_t start = ends[i].first;
+        idx_t end = ends[i].second;
+        if (start == IDX_UNDEF) {
+            continue;
+        }
+        m_succ_edges[succ_fill[start]] = edges[i].key;
+        m_succs[succ_fill[start]++] = end;
+        m_preds[pred_fill[end]++] = start;
+    }
+    m_enter_mark.assign(n, 0);
+    m_exit_mark.assign(n, 0);
+}
+
+void CsrGraph::reverse(const CsrGraph &g) {
+    clear();
+    const size_t n = g.size();
+    m_keys = g.m_keys;
+    m_keys.push_back(KEY_UNDEF);
+    m_index = g.m_index;
+    // successors: predecessors in g, then virtual exit -> sinks of g
+    m_succs = g.m_preds;
+    m_succ_begin.assign(g.m_pred_begin.begin(), g.m_pred_begin.end());
+    if (m_succ_begin.empty()) {
+        m_succ_begin.push_back(0);
+    }
+    for (idx_t i = 0; i < n; ++i) {
+        if (g.get_successor_count(i) == 0) {
+            m_succs.push_back(i);
+        }
+    }
+    m_succ_begin.push_back(static_cast<idx_t>(m_succs.size()));
+    m_succ_edges.assign(m_succs.size(), KEY_UNDEF);
+    // predecessors: successors in g; sinks of g get virtual exit
+    m_pred_begin.assign(n + 2, 0);
+    m_preds.reserve(g.m_succs.size() + m_succs.size() - g.m_preds.size());
+    for (idx_t i = 0; i < n; ++i) {
+        m_preds.insert(m_preds.end(), g.successors_begin(i), g.successors_end(i));
+        if (g.get_successor_count(i) == 0) {
+            m_preds.push_back(static_cast<idx_t>(n));
+        }
+        m_pred_begin[i + 1] = static_cast<idx_t>(m_preds.size());
+    }
+    m_pred_begin[n + 1] = static_cast<idx_t>(m_preds.size());
+    m_enter_mark.assign(n + 1, 0);
+    m_exit_mark.assign(n + 1, 0);
+}
+
+size_t CsrGraph::size() const { return m_keys.size(); }
+
+size_t CsrGraph::edge_count() const { return m_succs.size(); }
+
+idx_t CsrGraph::index(key_t key) const {
+    auto res = m_index.find(key);
+    if (res == m_index.end()) {
+        return IDX_UNDEF;
+    }
+    return res->second;
+}
+
+key_t CsrGraph::key(idx_t node) const {
+    if (node >= m_keys.size()) {
+        return KEY_UNDEF;
+    }
+    return m_keys[node];
+}
+
+const idx_t *CsrGraph::successors_begin(idx_t node) const {
+    return m_succs.data() + m_succ_begin[node];
+}
+
+const idx_t *CsrGraph::successors_end(idx_t node) const {
+    return m_succs.data() + m_succ_begin[node + 1];
+}
+
+const key_t *CsrGraph::out_edges_begin(idx_t node) const {
+    return m_succ_edges.data() + m_succ_begin[node];
+}
+
+const idx_t *CsrGraph::predecessors_begin(idx_t node) const {
+    return m_preds.data() + m_pred_begin[node];
+}
+
+const idx_t *CsrGraph::predecessors_end(idx_t node) const {
+    return m_preds.data() + m_pred_begin[node + 1];
+}
+
+size_t CsrGraph::get_successor_count(idx_t node) const {
+    return m_succ_begin[node + 1] - m_succ_begin[node];
+}
+
+size_t CsrGraph::get_predecessor_count(idx_t node) const {
+    return m_pred_begin[node + 1] - m_pred_begin[node];
+}
+
+void CsrGraph::DFS(idx_t root, std::vector<idx_t> &preorder, idx_t end) const {
+    struct Collector : CsrVisitor {
+        Collector(std::vector<idx_t> &out, idx_t end) : out(out), end(end) {}
+        bool pre(idx_t node) {
+            out.push_back(node);
+            return node != end;
+        }
+        std::vector<idx_t> &out;
+        idx_t end;
+    };
+    preorder.clear();
+    Collector collector{preorder, end};
+    DFS_visit(root, collector);
+}
+
+void CsrGraph::RPO(idx_t root, std::vector<idx_t> &rpo) const {
+    struct Collector : CsrVisitor {
+        Collector(std::vector<idx_t> &out) : out(out) {}
+        void post(idx_t node) { out.push_back(node); }
+        std::vector<idx_t> &out;
+    };
+    rpo.clear();
+    Collector collector{rpo};
+    DFS_visit(root, collector);
+    std::reverse(rpo.begin(), rpo.end());
+}
+
+bool CsrGraph::hasPath(idx_t start, idx_t end) const {
+    struct Finder : CsrVisitor {
+        Finder(idx_t end) : end(end) {}
+        bool pre(idx_t node) {
+            found = (node == end);
+            return !found;
+        }
+        idx_t end;
+        bool found{false};
+    };
+    Finder finder{end};
+    DFS_visit(start, finder);
+    return finder.found;
+}
+
+void CsrGraph::back_edges(idx_t root, std::vector<std::pair<idx_t, idx_t>> &edges) const {
+    struct Collector : CsrVisitor {
+        Collector(std::vector<std::pair<idx_t, idx_t>> &out) : out(out) {}
+        void back_edge(idx_t from, idx_t to) { out.emplace_back(from, to); }
+        std::vector<std::pair<idx_t, idx_t>> &out;
+    };
+    edges.clear();
+    Collector collector{edges};
+    DFS_visit(root, collector);
+}
+
+idx_t CsrGraph::SCC(std::vector<idx_t> &component) const {
+    const size_t n = size();
+    component.assign(n, IDX_UNDEF);
+    // preorder number & lowlink; a node stays on the Tarjan stack until its component is done
+    std::vector<idx_t> num(n, IDX_UNDEF);
+    std::vector<idx_t> low(n, IDX_UNDEF);
+    std::vector<idx_t> open{};
+    auto &stack = m_dfs_stack;
+    stack.clear();
+    idx_t counter{0};
+    idx_t count{0};
+    auto enter = [&](idx_t node) {
+        num[node] = low[node] = counter++;
+        open.push_back(node);
+        stack.emplace_back(node, successors_begin(node));
+    };
+    for (idx_t root = 0; root < n; ++root) {
+        if (num[root] != IDX_UNDEF) {
+            continue;
+        }
+        enter(root);
+        while (!stack.empty()) {
+            auto &top = stack.back();
+            idx_t node = top.first;
+            if (top.second != successors_end(node)) {
+                idx_t succ = *top.second++;
+                if (num[succ] == IDX_UNDEF) {
+                    enter(succ);
+                } else if (component[succ] == IDX_UNDEF) {
+                    low[node] = std::min(low[node], num[succ]);
+                }
+                continue;
+            }
+            stack.pop_back();
+            if (low[node] == num[node]) {
+                idx_t member{IDX_UNDEF};
+                do {
+                    member = open.back();
+                    open.pop_back();
+                    component[member] = count;
+                } while (member != node);
+                ++count;
+            }
+            if (!stack.empty()) {
+                idx_t parent = stack.back().first;
+                low[parent] = std::min(low[parent], low[node]);
+            }
+        }
+    }
+    return count;
+}
+
+} // namespace G
@@ -0,0 +1,293 @@
+#include "domTree.hpp"
+#include <algorithm>
+
+namespace G {
+
+void DomTree::clear() {
+    m_root = IDX_UNDEF;
+    m_idom.clear();
+    m_depth.clear();
+    m_preorder.clear();
+    m_dfs_in.clear();
+    m_dfs_out.clear();
+    m_child_begin.clear();
+    m_children.clear();
+    m_num.clear();
+    m_dirty = false;
+    m_pending = 0;
+    m_updates = 0;
+}
+
+void DomTree::build(idx_t root, const CsrGraph &g) {
+    clear();
+    const size_t n = g.size();
+    m_idom.assign(n, IDX_UNDEF);
+    m_depth.assign(n, IDX_UNDEF);
+    if (root >= n) {
+        OPT(LOG("Wrong dominator tree root"));
+        return;
+    }
+    m_root = root;
+    m_num.assign(n, IDX_UNDEF);
+    semi_nca_(g, root, [](idx_t) { return true; });
+    number_();
+}
+
+size_t DomTree::pending() const { return m_pending; }
+size_t DomTree::updates() const { return m_updates; }
+
+void DomTree::renumber_() const {
+    m_pending = 0;
+    if (m_dirty) {
+        number_();
+    }
+}
+
+void DomTree::number_() const {
+    m_dirty = false;
+    const size_t n = m_idom.size();
+    // children ranges (counting sort by idom)
+    m_child_begin.assign(n + 1, 0);
+    for (size_t i = 0; i < n; ++i) {
+        if (m_idom[i] != IDX_UNDEF) {
+            ++m_child_begin[m_idom[i] + 1];
+        }
+    }
+    for (size_t i = 0; i < n; ++i) {
+        m_child_begin[i + 1] += m_child_begin[i];
+    }
+    m_children.assign(m_child_begin[n], IDX_UNDEF);
+    std::vector<idx_t> fill(m_child_begin.begin(), m_child_begin.end() - 1);
+    for (size_t i = 0; i < n; ++i) {
+        if (m_idom[i] != IDX_UNDEF) {
+            m_children[fill[m_idom[i]]++] = static_cast<idx_t>(i);
+        }
+    }
+
+    m_depth.assign(n, IDX_UNDEF);
+    m_dfs_in.assign(n, IDX_UNDEF);
+    m_dfs_out.assign(n, IDX_UNDEF);
+    m_preorder.clear();
+    if (m_root == IDX_UNDEF) {
+        return;
+    }
+    idx_t counter{0};
+    std::vector<std::pair<idx_t, const idx_t *>> stack{};
+    m_depth[m_root] = 0;
+    m_dfs_in[m_root] = counter++;
+    m_preorder.push_back(m_root);
+    stack.emplace_back(m_root, m_children.data() + m_child_begin[m_root]);
+    while (!stack.empty()) {
+        auto &top = stack.back();
+        if (top.second == m_children.data() + m_child_begin[top.first + 1]) {
+            m_dfs_out[top.first] = counter++;
+            stack.pop_back();
+            continue;
+        }
+        idx_t parent = top.first;
+        idx_t child = *top.second++;
+        m_depth[child] = m_depth[parent] + 1;
+        m_dfs_in[child] = counter++;
+        m_preorder.push_back(child);
+        stack.emplace_back(child, m_children.data() + m_child_begin[child]);
+    }
+}
+
+idx_t DomTree::root() const { return m_root; }
+
+size_t DomTree::size() const {
+    renumber_();
+    return m_preorder.size();
+}
+
+bool DomTree::reachable(idx_t node) const {
+    renumber_();
+    return reachable_(node);
+}
+
+bool DomTree::reachable_(idx_t node) const {
+    return node < m_depth.size() && m_depth[node] != IDX_UNDEF;
+}
+
+idx_t DomTree::idom(idx_t node) const {
+    if (node >= m_idom.size()) {
+        return IDX_UNDEF;
+    }
+    return m_idom[node];
+}
+
+idx_t DomTree::depth(idx_t node) const {
+    renumber_();
+    if (node >= m_depth.size()) {
+        return IDX_UNDEF;
+    }
+    return m_depth[node];
+}
+
+idx_t DomTree::nca(idx_t a, idx_t b) const {
+    renumber_();
+    return nca_(a, b);
+}
+
+idx_t DomTree::nca_(idx_t a, idx_t b) const {
+    if (!reachable_(a) || !reachable_(b)) {
+        return IDX_UNDEF;
+    }
+    while (m_depth[a] > m_depth[b]) {
+        a = m_idom[a];
+    }
+    while (m_depth[b] > m_depth[a]) {
+        b = m_idom[b];
+    }
+    while (a != b) {
+        a = m_idom[a];
+        b = m_idom[b];
+    }
+    return a;
+}
+
+bool DomTree::dominates(idx_t a, idx_t b) const {
+    renumber_();
+    return dominates_(a, b);
+}
+
+bool DomTree::dominates_(idx_t a, idx_t b) const {
+    if (!reachable_(a) || !reachable_(b)) {
+        return false;
+    }
+    return m_dfs_in[a] <= m_dfs_in[b] && m_dfs_out[b] <= m_dfs_out[a];
+}
+
+bool DomTree::strictly_dominates(idx_t a, idx_t b) const { return a != b && dominates(a, b); }
+
+idx_t DomTree::dfs_in(idx_t node) const {
+    renumber_();
+    if (node >= m_dfs_in.size()) {
+        return IDX_UNDEF;
+    }
+    return m_dfs_in[node];
+}
+
+idx_t DomTree::dfs_out(idx_t node) const {
+    renumber_();
+    if (node >= m_dfs_out.size()) {
+        return IDX_UNDEF;
+    }
+    return m_dfs_out[node];
+}
+
+const idx_t *DomTree::children_begin(idx_t node) const {
+    renumber_();
+    if (node + 1 >= m_child_begin.size()) {
+        return nullptr;
+    }
+    return m_children.data() + m_child_begin[node];
+}
+
+const idx_t *DomTree::children_end(idx_t node) const {
+    renumber_();
+    if (node + 1 >= m_child_begin.size()) {
+        return nullptr;
+    }
+    return m_children.data() + m_child_begin[node + 1];
+}
+
+const std::vector<idx_t> &DomTree::preorder() const {
+    renumber_();
+    return m_preorder;
+}
+
+void DomFrontier::clear() {
+    m_begin.clear();
+    m_frontier.clear();
+}
+
+void DomFrontier::build(const DomTree &tree, const CsrGraph &g) {
+    clear();
+    const size_t n = g.size();
+    // (runner, join) pairs; last[runner] dedups repeated walks to the same join
+    std::vector<std::pair<idx_t, idx_t>> pairs{};
+    std::vector<idx_t> last(n, IDX_UNDEF);
+    m_begin.assign(n + 1, 0);
+    for (idx_t join : tree.preorder()) {
+        // root has an implicit entry edge: one more pred makes it a join
+        if (join != tree.root() && g.get_predecessor_count(join) < 2) {
+            continue;
+        }
+        idx_t dom = tree.idom(join);
+        for (auto *it = g.predecessors_begin(join); it != g.predecessors_end(join); ++it) {
+            idx_t runner = *it;
+            if (!tree.reachable(runner)) {
+                continue;
+            }
+            while (runner != dom && last[runner] != join) {
+                last[runner] = join;
+                pairs.emplace_back(runner, join);
+                ++m_begin[runner + 1];
+                runner = tree.idom(runner);
+            }
+        }
+    }
+    for (size_t i = 0; i < n; ++i) {
+        m_begin[i + 1] += m_begin[i];
+    }
+    m_frontier.assign(pairs.size(), IDX_UNDEF);
+    std::vector<idx_t> fill(m_begin.begin(), m_begin.end() - 1);
+    for (auto &item : pairs) {
+        m_frontier[fill[item.first]++] = item.second;
+    }
+}
+
+size_t DomFrontier::size() const { return m_begin.empty() ? 0 : m_begin.size() - 1; }
+
+const idx_t *DomFrontier::frontier_begin(idx_t node) const {
+    if (node >= size()) {
+        return nullptr;
+    }
+    return m_frontier.data() + m_begin[node];
+}
+
+const idx_t *DomFrontier::frontier_end(idx_t node) const {
+    if (node >= size()) {
+        return nullptr;
+    }
+    return m_frontier.data() + m_begin[node + 1];
+}
+
+size_t DomFrontier::get_frontier_size(idx_t node) const {
+    if (node >= size()) {
+        return 0;
+    }
+    return m_begin[node + 1] - m_begin[node];
+}
+
+void DomFrontier::iterated(const std::vector<idx_t> &defs, std::vector<idx_t> &result) const {
+    result.clear();
+    std::vector<bool> in_result(size(), false);
+    std::vector<bool> queued(size(), false);
+    std::vector<idx_t> worklist{};
+    for (idx_t def : defs) {
+        if (def < size() && !queued[def]) {
+            queued[def] = true;
+            worklist.push_back(def);
+        }
+    }
+    while (!worklist.empty()) {
+        idx_t node = worklist.back();
+        worklist.pop_back();
+        for (auto *it = frontier_begin(node); it != frontier_end(node); ++it) {
+            if (in_result[*it]) {
+                continue;
+            }
+            in_result[*it] = true;
+            result.push_back(*it);
+            if (!queued[*it]) {
+                queued[*it] = true;
+                worklist.push_back(*it);
+            }
+        }
+    }
+    std::sort(result.begin(), result.end());
+}
+
+} // namespace G
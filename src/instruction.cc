@@ -4,10 +4,78 @@
 #include <algorithm>
 #include <set>
 #include <sstream>
+#include <stdexcept>
+#include <vector>
 namespace IR {
 
+/* Use class */
+Use::~Use() { unlink_(); }
+
+void Use::link_(InstrBase *val) {
+    m_val = val;
+    if (val == nullptr) {
+        return;
+    }
+    m_next = val->m_users;
+    if (m_next != nullptr) {
+        m_next->m_prev = &m_next;
+    }
+    m_prev = &val->m_users;
+    val->m_users = this;
+    ++val->m_user_count;
+}
+
+void Use::unlink_() {
+    if (m_val == nullptr) {
+        return;
+    }
+    *m_prev = m_next;
+    if (m_next != nullptr) {
+        m_next->m_prev = m_prev;
+    }
+    --m_val->m_user_count;
+    m_val = nullptr;
+    m_next = nullptr;
+    m_prev = nullptr;
+}
+
+void Use::set(InstrBase *val) {
+    unlink_();
+    link_(val);
+}
+
+void Use::relocate_(Use &other) {
+    m_val = other.m_val;
+    m_user = other.m_user;
+    m_next = other.m_next;
+    m_prev = other.m_prev;
+    if (m_val != nullptr) {
+        *m_prev = this;
+        if (m_next != nullptr) {
+            m_next->m_prev = &m_next;
+        }
+    }
+    other.m_val = nullptr;
+    other.m_next = nullptr;
+    other.m_prev = nullptr;
+}
+
 /* Instr Base class */
-InstrBase::~InstrBase() {}
+InstrBase::~InstrBase() {
+    // users keep a null operand: their slots must not reach into this later
+    for (Use *use = m_users; use != nullptr;) {
+        Use *next = use->m_next;
+        use->m_val = nullptr;
+        use->m_next = nullptr;
+        use->m_prev = nullptr;
+        use = next;
+    }
+    m_users = nullptr;
+    drop_inputs();
+    if (m_inputs != m_inline_inputs) {
+        delete[] m_inputs;
+    }
+}
 InstrBase::InstrBase(id_t id) : m_id(id) {}
 InstrBase::InstrBase(BasicBlock &bb, id_t id) : m_bb(&bb), m_id(id) {}
 
@@ -15,29 +83,35 @@ void InstrBase::set_prev(InstrBase *instr) { m_prev = instr; }
 void InstrBase::set_next(InstrBase *instr) { m_next = instr; }
 void InstrBase::set_bb(BasicBlock *bb) { m_bb = bb; }
 void InstrBase::set_id(id_t id) { m_id = id; }
+void InstrBase::set_order(size_t order) { m_order = order; }
 std::string InstrBase::dump() const { return "???"; };
 InstrBase *InstrBase::prev() const { return m_prev; }
 InstrBase *InstrBase::next() const { return m_next; }
 
-InstrBase::UserListIt InstrBase::users_begin() { return m_users.begin(); }
-InstrBase::UserListIt InstrBase::users_end() { return m_users.end(); }
-InstrBase::UserListIt InstrBase::users_last() {
-    if (m_users.size() == 0) {
-        return m_users.end();
+InstrBase::UserIt InstrBase::users_begin() const { return UserIt{m_users}; }
+InstrBase::UserIt InstrBase::users_end() const { return UserIt{nullptr}; }
+size_t InstrBase::user_count() const { return m_user_count; }
+
+InstrBase::InputIt InstrBase::inputs_begin() const { return InputIt{m_inputs}; }
+InstrBase::InputIt InstrBase::inputs_end() const { return InputIt{m_inputs + m_input_count}; }
+size_t InstrBase::input_count() const { return m_input_count; }
+
+InstrBase *InstrBase::input(size_t index) const {
+    if (index >= m_input_count) {
+        return nullptr;
     }
-    return --m_users.end();
+    return m_inputs[index].get();
 }
 
-InstrBase::InputListIt InstrBase::inputs_begin() { return m_inputs.begin(); }
-InstrBase::InputListIt InstrBase::inputs_end() { return m_inputs.end(); }
-InstrBase::InputListIt InstrBase::inputs_last() {
-    if (m_users.size() == 0) {
-        return m_inputs.end();
+Use &InstrBase::input_use(size_t index) {
+    if (index >= m_input_count) {
+        throw std::out_of_range("Wrong operand index");
     }
-    return --m_inputs.end();
+    return m_inputs[index];
 }
 
 id_t InstrBase::get_id() const { return m_id; }
+size_t InstrBase::order() const { return m_order; }
 
 BasicBlock *InstrBase::bb() const { return m_bb; }
 
@@ -45,47 +119,91 @@ void InstrBase::forget_dependencies() {
     m_prev = nullptr;
     m_next = nullptr;
     m_bb = nullptr;
-    m_users.clear();
-    m_inputs.clear();
+    drop_inputs();
 }
 
-void InstrBase::push_user(InstrBase *elem) {
-    if (!elem) {
-        throw std::logic_error("nullptr user");
+void InstrBase::reserve_inputs_(size_t capacity) {
+    if (capacity <= m_input_capacity) {
+        return;
     }
-    // bool duplicate = (std::find(m_users.begin(), m_users.end(), elem) != m_users.end());
-
-    // if (duplicate) {
-    //     throw std::logic_error("Instr has already had this user");
-    // }
-    // duplicate =
-    //     (std::find(elem->m_inputs.begin(), elem->m_inputs.end(), this) != elem->m_inputs.end());
+    Use *data = new Use[capacity];
+    for (size_t i = 0; i < m_input_count; ++i) {
+        data[i].relocate_(m_inputs[i]);
+    }
+    if (m_inputs != m_inline_inputs) {
+        delete[] m_inputs;
+    }
+    m_inputs = data;
+    m_input_capacity = capacity;
+}
 
-    // if (duplicate) {
-    //     throw std::logic_error("User has already had this instruction");
-    // }
+void InstrBase::drop_inputs() {
+    for (size_t i = 0; i < m_input_count; ++i) {
+        m_inputs[i].unlink_();
+    }
+    m_input_count = 0;
+}
 
-    elem->m_inputs.push_back(this);
-    m_users.push_back(elem);
+void InstrBase::drop_users() {
+    while (m_users != nullptr) {
+        InstrBase *user = m_users->m_user;
+        for (size_t i = 0; i < user->m_input_count;) {
+            if (user->m_inputs[i].get() == this) {
+                user->erase_input(i);
+            } else {
+                ++i;
+            }
+        }
+    }
 }
 
-// InstrBase::UserListIt InstrBase::erase_user(UserListIt cit) { return m_users.erase(cit); }
+void InstrBase::push_user(InstrBase *elem) {
+    if (!elem) {
+        throw std::logic_error("nullptr user");
+    }
+    elem->push_input(this);
+}
 
 bool InstrBase::erase_user(id_t bb_id, id_t id) {
-    InputListIt it = m_users.begin();
-    bool edited{false};
-    while (it != m_users.end()) {
-        auto *user = *it;
+    // users to edit are collected first: erasing an operand moves later operands of the user
+    std::vector<InstrBase *> users{};
+    for (Use *use = m_users; use != nullptr; use = use->m_next) {
+        auto *user = use->m_user;
         ASSERT_DEV(user->bb(), "nullptr bb");
-        if (user->bb()->get_id() == bb_id && user->get_id() == id) {
-            user->m_inputs.remove(this);
-            it = m_users.erase(it);
-            edited = true;
-        } else {
-            ++it;
+        if (user->bb()->get_id() == bb_id && user->get_id() == id &&
+            std::find(users.begin(), users.end(), user) == users.end()) {
+            users.push_back(user);
         }
     }
-    return edited;
+    for (auto *user : users) {
+        for (size_t i = 0; i < user->m_input_count;) {
+            if (user->m_inputs[i].get() == this) {
+                user->erase_input(i);
+            } else {
+                ++i;
+            }
+        }
+    }
+    return !users.empty();
+}
+
+void InstrBase::setOperand(size_t index, InstrBase *instr) {
+    if (instr == nullptr) {
+        throw std::logic_error("nullptr operand");
+    }
+    input_use(index).set(instr);
+}
+
+void InstrBase::replaceAllUsesWith(InstrBase *instr) {
+    if (instr == nullptr) {
+        throw std::logic_error("nullptr replacement");
+    }
+    if (instr == this) {
+        return;
+    }
+    while (m_users != nullptr) {
+        m_users->set(instr);
+    }
 }
 
 void InstrBase::push_users(initList list) {
@@ -100,40 +218,38 @@ void InstrBase::push_users(initList list) {
 }
 
 void InstrBase::push_input(InstrBase *elem) {
-
     if (elem == nullptr) {
         throw std::logic_error("nullptr pushed");
     }
-
-    // bool duplicate = (std::find(m_inputs.begin(), m_inputs.end(), elem) != m_inputs.end());
-    // if (duplicate) {
-    //     throw std::logic_error("Instr has already had this input");
-    // }
-    // duplicate =
-    //     (std::find(elem->m_users.begin(), elem->m_users.end(), this) != elem->m_users.end());
-
-    // if (duplicate) {
-    //     throw std::logic_error("Input has already had this instruction");
-    // }
-
-    elem->m_users.push_back(this);
-    m_inputs.push_back(elem);
+    if (m_input_count == m_input_capacity) {
+        reserve_inputs_(2 * m_input_capacity);
+    }
+    Use &use = m_inputs[m_input_count++];
+    use.m_user = this;
+    use.link_(elem);
 }
 
-// InstrBase::InputListIt InstrBase::erase_input(InputListIt it) { return m_inputs.erase(it); }
+void InstrBase::erase_input(size_t index) {
+    if (index >= m_input_count) {
+        return;
+    }
+    m_inputs[index].unlink_();
+    for (size_t i = index; i + 1 < m_input_count; ++i) {
+        m_inputs[i].relocate_(m_inputs[i + 1]);
+    }
+    --m_input_count;
+}
 
 bool InstrBase::erase_input(id_t bb_id, id_t id) {
-    InputListIt it = m_inputs.begin();
     bool edited{false};
-    while (it != m_inputs.end()) {
-        auto *input = *it;
+    for (size_t i = 0; i < m_input_count;) {
+        auto *input = m_inputs[i].get();
         ASSERT_DEV(input->bb(), "nullptr bb");
         if (input->bb()->get_id() == bb_id && input->get_id() == id) {
-            input->m_users.remove(this);
-            it = m_inputs.erase(it);
+            erase_input(i);
             edited = true;
         } else {
-            ++it;
+            ++i;
         }
     }
     return edited;
@@ -152,53 +268,54 @@ void InstrBase::push_inputs(initList list) {
 
 bool InstrBase::onlyOneInput() const {
     std::set<key_t> keys{};
-    for (auto i : m_inputs) {
-        keys.insert(i->get_id());
+    for (auto it = inputs_begin(); it != inputs_end(); ++it) {
+        keys.insert((*it)->get_id());
     }
     return (keys.size() == 1);
 }
 
 bool InstrBase::onlyOneUser() const {
     std::set<key_t> keys{};
-    for (auto i : m_users) {
-        keys.insert(i->get_id());
+    for (auto it = users_begin(); it != users_end(); ++it) {
+        keys.insert((*it)->get_id());
     }
     return (keys.size() == 1);
 }
 
-InstrBase::UsersT &InstrBase::users() & { return m_users; }
-InstrBase::InputsT &InstrBase::inputs() & { return m_inputs; }
-
 void InstrBase::throwIfWrongDeps_() const {
     if (!m_bb) {
         throw std::logic_error("Instr without bb");
     }
     // analyze inputs
-    for (auto input : m_inputs) {
+    for (size_t i = 0; i < m_input_count; ++i) {
+        auto *input = m_inputs[i].get();
         if (!input) {
             throw std::logic_error("nullptr in inputs");
         }
         if (!input->bb()) {
             throw std::logic_error("input has no bb");
         }
-        // check dfg
-        bool correct_input_dep =
-            (std::find(input->m_users.begin(), input->m_users.end(), this) != input->m_users.end());
+        // check dfg: operand slot is on use-list of its definition
+        bool correct_input_dep{false};
+        for (Use *use = input->m_users; use != nullptr && !correct_input_dep; use = use->m_next) {
+            correct_input_dep = (use == &m_inputs[i]);
+        }
         if (!correct_input_dep) {
             throw std::logic_error("Wrong input dependency");
         }
     }
     // analyze users
-    for (auto user : m_users) {
+    for (Use *use = m_users; use != nullptr; use = use->m_next) {
+        auto *user = use->m_user;
         if (!user) {
             throw std::logic_error("nullptr in users");
         }
         if (!user->bb()) {
             throw std::logic_error("user has no bb");
         }
-        // check dfg
-        bool correct_user_dep =
-            (std::find(user->m_inputs.begin(), user->m_inputs.end(), this) != user->m_inputs.end());
+        // check dfg: use is an operand slot of user referring to this
+        bool correct_user_dep = use->m_val == this && use >= user->m_inputs &&
+                                use < user->m_inputs + user->m_input_count;
         if (!correct_user_dep) {
             throw std::logic_error("Wrong input dependency");
         }
@@ -234,19 +351,19 @@ void Instr::throwIfWrongInputCount_() const {
     case OpcodeType::AND:
     case OpcodeType::XOR:
     case OpcodeType::SHL:
-        if (m_inputs.size() != 2) {
+        if (m_input_count != 2) {
             throw std::logic_error("Wrong input count");
         }
         break;
     case OpcodeType::MOVI:
     case OpcodeType::CHECK1:
     case OpcodeType::CHECK2:
-        if (m_inputs.size() != 1) {
+        if (m_input_count != 1) {
             throw std::logic_error("Wrong input count");
         }
         break;
     case OpcodeType::ICONST:
-        if (!m_inputs.empty()) {
+        if (m_input_count != 0) {
             throw std::logic_error("Wrong input count");
         }
         break;
@@ -272,7 +389,8 @@ std::string Instr::dump() const {
         ss $int(next) $__;
     }
     ss $("I: ");
-    for (auto ptr : m_inputs) {
+    for (auto it = inputs_begin(); it != inputs_end(); ++it) {
+        auto *ptr = *it;
         ASSERT_DEV(ptr, "Nullptr input");
         if (ptr != nullptr) {
             ss << ptr->get_id() << " ";
@@ -280,7 +398,8 @@ std::string Instr::dump() const {
     }
     ss $__;
     ss $("U: ");
-    for (auto ptr : m_users) {
+    for (auto it = users_begin(); it != users_end(); ++it) {
+        auto *ptr = *it;
         ASSERT_DEV(ptr, "Nullptr user");
         if (ptr != nullptr) {
             ss << ptr->get_id() << " ";
@@ -296,7 +415,8 @@ Phy::Phy(id_t id) : InstrBase(id) {}
 std::string Phy::dump() const {
     std::stringstream ss{};
     ss << "PHY( ";
-    for (const auto *elem : m_users) {
+    for (auto it = users_begin(); it != users_end(); ++it) {
+        const auto *elem = *it;
         ss << elem->bb()->get_id() << ":" << elem->get_id();
 
         ss << "; ";
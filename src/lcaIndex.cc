@@ -0,0 +1,126 @@
+#include "lcaIndex.hpp"
+#include <algorithm>
+
+namespace G {
+
+void LcaIndex::clear() {
+    m_parent.clear();
+    m_root.clear();
+    m_in.clear();
+    m_order.clear();
+    m_table.clear();
+    m_log.clear();
+}
+
+void LcaIndex::build(const std::vector<idx_t> &parent) {
+    clear();
+    const size_t n = parent.size();
+    m_parent = parent;
+    // children ranges by counting sort
+    std::vector<idx_t> child_begin(n + 1, 0);
+    for (idx_t node = 0; node < n; ++node) {
+        if (parent[node] != IDX_UNDEF) {
+            ++child_begin[parent[node] + 1];
+        }
+    }
+    for (size_t i = 0; i < n; ++i) {
+        child_begin[i + 1] += child_begin[i];
+    }
+    std::vector<idx_t> children(child_begin[n]);
+    std::vector<idx_t> fill(child_begin.begin(), child_begin.end() - 1);
+    for (idx_t node = 0; node < n; ++node) {
+        if (parent[node] != IDX_UNDEF) {
+            children[fill[parent[node]]++] = node;
+        }
+    }
+
+    // preorder of every tree, roots in index order
+    m_root.assign(n, IDX_UNDEF);
+    m_in.assign(n, IDX_UNDEF);
+    m_order.reserve(n);
+    std::vector<idx_t> stack{};
+    for (idx_t root = 0; root < n; ++root) {
+        if (parent[root] != IDX_UNDEF) {
+            continue;
+        }
+        stack.push_back(root);
+        while (!stack.empty()) {
+            idx_t node = stack.back();
+            stack.pop_back();
+            m_root[node] = root;
+            m_in[node] = static_cast<idx_t>(m_order.size());
+            m_order.push_back(node);
+            for (idx_t i = child_begin[node + 1]; i-- > child_begin[node];) {
+                stack.push_back(children[i]);
+            }
+        }
+    }
+    if (m_order.size() != n) {
+        OPT(LOG("Parents form a cycle - nodes on it are left out"));
+    }
+
+    const size_t count = m_order.size();
+    m_log.assign(count + 1, 0);
+    for (size_t len = 2; len <= count; ++len) {
+        m_log[len] = m_log[len / 2] + 1;
+    }
+    m_table.emplace_back(count, IDX_UNDEF);
+    for (size_t i = 0; i < count; ++i) {
+        idx_t up = parent[m_order[i]];
+        m_table[0][i] = (up == IDX_UNDEF) ? IDX_UNDEF : m_in[up];
+    }
+    for (size_t k = 1; (size_t{1} << k) <= count; ++k) {
+        const size_t half = size_t{1} << (k - 1);
+        const auto &prev = m_table[k - 1];
+        std::vector<idx_t> level(count - (size_t{1} << k) + 1);
+        for (size_t i = 0; i < level.size(); ++i) {
+            level[i] = std::min(prev[i], prev[i + half]);
+        }
+        m_table.push_back(std::move(level));
+    }
+}
+
+void LcaIndex::build(const DomTree &tree) {
+    // size counts reachable nodes only; greater indices are left out anyway
+    const auto &preorder = tree.preorder();
+    idx_t n = preorder.empty() ? 0 : *std::max_element(preorder.begin(), preorder.end()) + 1;
+    std::vector<idx_t> parent(n, IDX_UNDEF);
+    for (idx_t node = 0; node < n; ++node) {
+        parent[node] = tree.idom(node);
+    }
+    build(parent);
+    // unreachable nodes are roots of their own; drop them
+    for (idx_t node = 0; node < n; ++node) {
+        if (!tree.reachable(node)) {
+            m_root[node] = IDX_UNDEF;
+        }
+    }
+}
+
+size_t LcaIndex::size() const { return m_parent.size(); }
+
+bool LcaIndex::contains(idx_t node) const {
+    return node < m_root.size() && m_root[node] != IDX_UNDEF;
+}
+
+idx_t LcaIndex::root(idx_t node) const {
+    if (node >= m_root.size()) {
+        return IDX_UNDEF;
+    }
+    return m_root[node];
+}
+
+idx_t LcaIndex::lca(idx_t a, idx_t b) const {
+    if (!contains(a) || !contains(b) || m_root[a] != m_root[b]) {
+        return IDX_UNDEF;
+    }
+    if (a == b) {
+        return a;
+    }
+    idx_t l = std::min(m_in[a], m_in[b]) + 1;
+    idx_t r = std::max(m_in[a], m_in[b]);
+    idx_t k = m_log[r - l + 1];
+    return m_order[std::min(m_table[k][l], m_table[k][r + 1 - (size_t{1} << k)])];
+}
+
+} // namespace G
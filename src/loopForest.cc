@@ -0,0 +1,334 @@
+#include "loopForest.hpp"
+#include <numeric>
+#include <set>
+
+namespace G {
+
+void LoopForest::clear() {
+    m_type.clear();
+    m_header.clear();
+    m_back_edge_start.clear();
+    m_headers.clear();
+}
+
+void LoopForest::build(idx_t root, const CsrGraph &g) {
+    clear();
+    const size_t n = g.size();
+    m_type.assign(n, LoopT::NONE);
+    m_header.assign(n, IDX_UNDEF);
+    m_back_edge_start.assign(n, IDX_UNDEF);
+    if (root >= n) {
+        OPT(LOG("Wrong loop forest root"));
+        return;
+    }
+
+    // DFS preorder numbers; last[w] is the greatest number in DFS subtree of w
+    struct Numbering : CsrVisitor {
+        Numbering(size_t n) : num(n, IDX_UNDEF) {}
+        bool pre(idx_t node) {
+            num[node] = static_cast<idx_t>(order.size());
+            order.push_back(node);
+            last.push_back(IDX_UNDEF);
+            return true;
+        }
+        void post(idx_t node) { last[num[node]] = static_cast<idx_t>(order.size() - 1); }
+        std::vector<idx_t> num;
+        std::vector<idx_t> order{};
+        std::vector<idx_t> last{};
+    };
+    Numbering dfs{n};
+    g.DFS_visit(root, dfs);
+    const auto &num = dfs.num;
+    const auto &order = dfs.order;
+    const idx_t count = static_cast<idx_t>(order.size());
+    auto is_ancestor = [&dfs](idx_t w, idx_t v) { return w <= v && v <= dfs.last[w]; };
+
+    // collapsed loops are union-find sets named by their header (in preorder numbers)
+    std::vector<idx_t> set(count);
+    std::iota(set.begin(), set.end(), 0);
+    auto find = [&set](idx_t x) {
+        while (set[x] != x) {
+            set[x] = set[set[x]];
+            x = set[x];
+        }
+        return x;
+    };
+    // preds entering a collapsed irreducible loop bypassing its header, as raw preorder
+    // numbers: y is inside loop of w iff w is an ancestor of y, no need to chase find(y)
+    std::vector<std::set<idx_t>> entries(count);
+    std::vector<idx_t> in_body(count, IDX_UNDEF);
+    std::vector<idx_t> body{};
+    std::vector<idx_t> worklist{};
+
+    // innermost loops first
+    for (idx_t w = count; w-- > 0;) {
+        const idx_t node = order[w];
+        body.clear();
+        for (auto *it = g.predecessors_begin(node); it != g.predecessors_end(node); ++it) {
+            idx_t v = num[*it];
+            if (v == IDX_UNDEF || !is_ancestor(w, v)) {
+                continue;
+            }
+            if (m_back_edge_start[node] == IDX_UNDEF) {
+                m_back_edge_start[node] = *it;
+            }
+            v = find(v);
+            if (v != w && in_body[v] != w) {
+                in_body[v] = w;
+                body.push_back(v);
+            }
+        }
+        if (m_back_edge_start[node] == IDX_UNDEF) {
+            continue;
+        }
+        // walk non-back predecessors backwards until header is met
+        std::set<idx_t> outside{};
+        worklist = body;
+        auto absorb = [&](idx_t y) {
+            y = find(y);
+            if (y != w && in_body[y] != w) {
+                in_body[y] = w;
+                body.push_back(y);
+                worklist.push_back(y);
+            }
+        };
+        while (!worklist.empty()) {
+            idx_t x = worklist.back();
+            worklist.pop_back();
+            const idx_t x_node = order[x];
+            for (auto *it = g.predecessors_begin(x_node); it != g.predecessors_end(x_node); ++it) {
+                idx_t v = num[*it];
+                // back edges into x belong to the loop of x, already collapsed
+                if (v == IDX_UNDEF || is_ancestor(x, v)) {
+                    continue;
+                }
+                if (is_ancestor(w, v)) {
+                    absorb(v);
+                } else {
+                    outside.insert(v);
+                }
+            }
+            // entries of inner loop: merge smaller into larger, then take those inside w
+            auto &inner = entries[x];
+            if (inner.size() > outside.size()) {
+                std::swap(inner, outside);
+            }
+            outside.insert(inner.begin(), inner.end());
+            inner.clear();
+            auto it = outside.lower_bound(w);
+            while (it != outside.end() && *it <= dfs.last[w]) {
+                absorb(*it);
+                it = outside.erase(it);
+            }
+        }
+        m_type[node] = outside.empty() ? LoopT::REDUCIBLE : LoopT::IRREDUCIBLE;
+        entries[w] = std::move(outside);
+        for (idx_t x : body) {
+            m_header[order[x]] = node;
+            set[x] = w;
+        }
+    }
+
+    for (idx_t node : order) {
+        if (m_type[node] != LoopT::NONE) {
+            m_headers.push_back(node);
+        }
+    }
+}
+
+size_t LoopForest::size() const { return m_type.size(); }
+
+bool LoopForest::is_header(idx_t node) const {
+    return node < m_type.size() && m_type[node] != LoopT::NONE;
+}
+
+bool LoopForest::is_irreducible(idx_t header) const {
+    return header < m_type.size() && m_type[header] == LoopT::IRREDUCIBLE;
+}
+
+idx_t LoopForest::loop(idx_t node) const {
+    if (node >= m_header.size()) {
+        return IDX_UNDEF;
+    }
+    return is_header(node) ? node : m_header[node];
+}
+
+idx_t LoopForest::parent(idx_t header) const {
+    if (!is_header(header)) {
+        return IDX_UNDEF;
+    }
+    return m_header[header];
+}
+
+idx_t LoopForest::back_edge_start(idx_t header) const {
+    if (header >= m_back_edge_start.size()) {
+        return IDX_UNDEF;
+    }
+    return m_back_edge_start[header];
+}
+
+const std::vector<idx_t> &LoopForest::headers() const { return m_headers; }
+
+void LoopInfo::clear() {
+    m_forest.clear();
+    m_depth.clear();
+    m_tree_in.clear();
+    m_tree_size.clear();
+    m_preheader.clear();
+    m_latch_begin.clear();
+    m_latches.clear();
+    m_exit_begin.clear();
+    m_exits.clear();
+}
+
+void LoopInfo::build(idx_t root, const CsrGraph &g) {
+    clear();
+    m_forest.build(root, g);
+    const size_t n = g.size();
+    const auto &headers = m_forest.headers();
+
+    // headers come in preorder: parents before children
+    m_depth.assign(n, 0);
+    m_tree_size.assign(n, 0);
+    for (idx_t header : headers) {
+        idx_t parent = m_forest.parent(header);
+        m_depth[header] = (parent == IDX_UNDEF) ? 1 : m_depth[parent] + 1;
+        m_tree_size[header] = 1;
+    }
+    for (auto it = headers.rbegin(); it != headers.rend(); ++it) {
+        idx_t parent = m_forest.parent(*it);
+        if (parent != IDX_UNDEF) {
+            m_tree_size[parent] += m_tree_size[*it];
+        }
+    }
+    // preorder numbers: a child takes the next free slot of its parent's range
+    m_tree_in.assign(n, IDX_UNDEF);
+    std::vector<idx_t> next(n, IDX_UNDEF);
+    idx_t next_top{0};
+    for (idx_t header : headers) {
+        idx_t parent = m_forest.parent(header);
+        idx_t &slot = (parent == IDX_UNDEF) ? next_top : next[parent];
+        m_tree_in[header] = slot;
+        slot += m_tree_size[header];
+        next[header] = m_tree_in[header] + 1;
+    }
+    for (idx_t node = 0; node < n; ++node) {
+        idx_t header = m_forest.loop(node);
+        if (header != IDX_UNDEF) {
+            m_depth[node] = m_depth[header];
+        }
+    }
+
+    // latches & preheaders
+    m_latch_begin.assign(n + 1, 0);
+    m_preheader.assign(n, IDX_UNDEF);
+    for (idx_t header : headers) {
+        idx_t outside{IDX_UNDEF};
+        size_t outside_count{0};
+        for (auto *it = g.predecessors_begin(header); it != g.predecessors_end(header); ++it) {
+            if (contains(header, *it)) {
+                ++m_latch_begin[header + 1];
+            } else {
+                outside = *it;
+                ++outside_count;
+            }
+        }
+        if (!m_forest.is_irreducible(header) && outside_count == 1 &&
+            g.get_successor_count(outside) == 1) {
+            m_preheader[header] = outside;
+        }
+    }
+    for (size_t i = 0; i < n; ++i) {
+        m_latch_begin[i + 1] += m_latch_begin[i];
+    }
+    m_latches.assign(m_latch_begin[n], IDX_UNDEF);
+    for (idx_t header : headers) {
+        idx_t fill = m_latch_begin[header];
+        for (auto *it = g.predecessors_begin(header); it != g.predecessors_end(header); ++it) {
+            if (contains(header, *it)) {
+                m_latches[fill++] = *it;
+            }
+        }
+    }
+
+    // exits: edge leaving a loop leaves its inner loops as well
+    std::vector<std::pair<idx_t, std::pair<idx_t, idx_t>>> pairs{};
+    m_exit_begin.assign(n + 1, 0);
+    for (idx_t node = 0; node < n; ++node) {
+        if (m_forest.loop(node) == IDX_UNDEF) {
+            continue;
+        }
+        for (auto *it = g.successors_begin(node); it != g.successors_end(node); ++it) {
+            for (idx_t l = m_forest.loop(node); l != IDX_UNDEF && !contains(l, *it);
+                 l = m_forest.parent(l)) {
+                pairs.emplace_back(l, std::make_pair(node, *it));
+                ++m_exit_begin[l + 1];
+            }
+        }
+    }
+    for (size_t i = 0; i < n; ++i) {
+        m_exit_begin[i + 1] += m_exit_begin[i];
+    }
+    m_exits.assign(pairs.size(), {IDX_UNDEF, IDX_UNDEF});
+    std::vector<idx_t> fill(m_exit_begin.begin(), m_exit_begin.end() - 1);
+    for (auto &item : pairs) {
+        m_exits[fill[item.first]++] = item.second;
+    }
+}
+
+const LoopForest &LoopInfo::forest() const { return m_forest; }
+
+idx_t LoopInfo::depth(idx_t node) const {
+    if (node >= m_depth.size()) {
+        return 0;
+    }
+    return m_depth[node];
+}
+
+idx_t LoopInfo::loop(idx_t node) const { return m_forest.loop(node); }
+
+bool LoopInfo::contains(idx_t header, idx_t node) const {
+    idx_t l = m_forest.loop(node);
+    if (l == IDX_UNDEF || !m_forest.is_header(header)) {
+        return false;
+    }
+    return m_tree_in[header] <= m_tree_in[l] &&
+           m_tree_in[l] < m_tree_in[header] + m_tree_size[header];
+}
+
+const idx_t *LoopInfo::latches_begin(idx_t header) const {
+    if (header + 1 >= m_latch_begin.size()) {
+        return nullptr;
+    }
+    return m_latches.data() + m_latch_begin[header];
+}
+
+const idx_t *LoopInfo::latches_end(idx_t header) const {
+    if (header + 1 >= m_latch_begin.size()) {
+        return nullptr;
+    }
+    return m_latches.data() + m_latch_begin[header + 1];
+}
+
+const std::pair<idx_t, idx_t> *LoopInfo::exits_begin(idx_t header) const {
+    if (header + 1 >= m_exit_begin.size()) {
+        return nullptr;
+    }
+    return m_exits.data() + m_exit_begin[header];
+}
+
+const std::pair<idx_t, idx_t> *LoopInfo::exits_end(idx_t header) const {
+    if (header + 1 >= m_exit_begin.size()) {
+        return nullptr;
+    }
+    return m_exits.data() + m_exit_begin[header + 1];
+}
+
+idx_t LoopInfo::preheader(idx_t header) const {
+    if (header >= m_preheader.size()) {
+        return IDX_UNDEF;
+    }
+    return m_preheader[header];
+}
+
+} // namespace G
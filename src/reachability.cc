@@ -0,0 +1,150 @@
+#include "reachability.hpp"
+#include <algorithm>
+#include <iterator>
+
+namespace G {
+
+void Reachability::clear() {
+    m_component.clear();
+    m_count = 0;
+    m_bitset = false;
+    m_words = 0;
+    m_rows.clear();
+    m_post.clear();
+    m_interval_begin.clear();
+    m_intervals.clear();
+}
+
+void Reachability::build(const CsrGraph &g, idx_t bitset_limit) {
+    clear();
+    m_count = g.SCC(m_component);
+
+    // condensation w/o duplicate edges; component c has index c, edges go to smaller ids.
+    // Virtual root m_count leads to sources so that one DFS numbers the whole condensation
+    std::vector<key_t> keys(m_count + 1);
+    for (idx_t c = 0; c <= m_count; ++c) {
+        keys[c] = static_cast<key_t>(c) + 1;
+    }
+    std::vector<std::vector<idx_t>> members(m_count);
+    for (idx_t node = 0; node < g.size(); ++node) {
+        members[m_component[node]].push_back(node);
+    }
+    std::vector<CsrGraph::EdgeT> edges{};
+    std::vector<idx_t> seen(m_count, IDX_UNDEF);
+    std::vector<bool> source(m_count, true);
+    for (idx_t c = 0; c < m_count; ++c) {
+        for (idx_t node : members[c]) {
+            for (auto *it = g.successors_begin(node); it != g.successors_end(node); ++it) {
+                idx_t succ = m_component[*it];
+                if (succ != c && seen[succ] != c) {
+                    seen[succ] = c;
+                    source[succ] = false;
+                    edges.push_back({keys[c], keys[succ], KEY_UNDEF});
+                }
+            }
+        }
+    }
+    for (idx_t c = m_count; c-- > 0;) {
+        if (source[c]) {
+            edges.push_back({keys[m_count], keys[c], KEY_UNDEF});
+        }
+    }
+    CsrGraph dag{};
+    dag.build(keys, edges);
+
+    m_bitset = m_count <= bitset_limit;
+    if (m_bitset) {
+        build_bitset_(dag);
+    } else {
+        build_intervals_(dag);
+    }
+}
+
+void Reachability::build_bitset_(const CsrGraph &dag) {
+    m_words = (m_count + 63) / 64;
+    m_rows.assign(m_count * m_words, 0);
+    // successors have smaller ids, so their rows are complete
+    for (idx_t c = 0; c < m_count; ++c) {
+        uint64_t *row = m_rows.data() + c * m_words;
+        row[c / 64] |= uint64_t{1} << (c % 64);
+        for (auto *it = dag.successors_begin(c); it != dag.successors_end(c); ++it) {
+            const uint64_t *succ_row = m_rows.data() + *it * m_words;
+            for (size_t w = 0; w < m_words; ++w) {
+                row[w] |= succ_row[w];
+            }
+        }
+    }
+}
+
+void Reachability::build_intervals_(const CsrGraph &dag) {
+    // post numbers of a DFS tree: subtree of c holds posts [first[c], m_post[c]]
+    struct Numbering : CsrVisitor {
+        Numbering(size_t n, std::vector<idx_t> &out) : first(n, IDX_UNDEF), out(out) {}
+        bool pre(idx_t node) {
+            first[node] = counter;
+            return true;
+        }
+        void post(idx_t node) { out[node] = counter++; }
+        std::vector<idx_t> first;
+        std::vector<idx_t> &out;
+        idx_t counter{0};
+    };
+    m_post.assign(m_count + 1, IDX_UNDEF);
+    Numbering dfs{m_count + 1, m_post};
+    dag.DFS_visit(m_count, dfs);
+
+    // intervals of c: own subtree merged w/ intervals of successors, sinks first
+    m_interval_begin.assign(m_count + 1, 0);
+    std::vector<std::pair<idx_t, idx_t>> merged{};
+    for (idx_t c = 0; c < m_count; ++c) {
+        merged.clear();
+        merged.emplace_back(dfs.first[c], m_post[c]);
+        for (auto *it = dag.successors_begin(c); it != dag.successors_end(c); ++it) {
+            merged.insert(merged.end(), m_intervals.begin() + m_interval_begin[*it],
+                          m_intervals.begin() + m_interval_begin[*it + 1]);
+        }
+        std::sort(merged.begin(), merged.end());
+        for (auto &item : merged) {
+            idx_t last = static_cast<idx_t>(m_intervals.size());
+            if (last > m_interval_begin[c] && item.first <= m_intervals[last - 1].second + 1) {
+                m_intervals[last - 1].second = std::max(m_intervals[last - 1].second, item.second);
+            } else {
+                m_intervals.push_back(item);
+            }
+        }
+        m_interval_begin[c + 1] = static_cast<idx_t>(m_intervals.size());
+    }
+}
+
+size_t Reachability::size() const { return m_component.size(); }
+
+bool Reachability::is_bitset() const { return m_bitset; }
+
+idx_t Reachability::component(idx_t node) const {
+    if (node >= m_component.size()) {
+        return IDX_UNDEF;
+    }
+    return m_component[node];
+}
+
+bool Reachability::reaches(idx_t start, idx_t end) const {
+    idx_t from = component(start);
+    idx_t to = component(end);
+    if (from == IDX_UNDEF || to == IDX_UNDEF) {
+        return false;
+    }
+    if (from == to) {
+        return true;
+    }
+    if (m_bitset) {
+        return (m_rows[from * m_words + to / 64] >> (to % 64)) & 1;
+    }
+    // last interval starting at or before post of to
+    idx_t post = m_post[to];
+    auto begin = m_intervals.begin() + m_interval_begin[from];
+    auto end_it = m_intervals.begin() + m_interval_begin[from + 1];
+    auto it = std::upper_bound(begin, end_it, std::make_pair(post, IDX_UNDEF));
+    return it != begin && std::prev(it)->second >= post;
+}
+
+} // namespace G
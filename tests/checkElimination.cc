@@ -3,6 +3,9 @@
 #include "catch.hpp"
 #include "memManager.hpp"
 #include "checkElimination.hpp"
+#include "LoopTreeBuilder.hpp"
+#include "loopSimplify.hpp"
+#include "graphBuilder.hpp"
 
 /* CFG
 ┌───┐  3   ┌────┐
@@ -117,9 +120,233 @@ TEST_CASE("Test checkElimination", "[constfold2]") {
     g.throwIfNotConsistent();
     instrs.throwIfNotConsistent_();
 
+    // instr-level dominance
+    REQUIRE(g.instr_dominates(check1, check2));
+    REQUIRE(g.instr_dominates(i1, check1));
+    REQUIRE(!g.instr_dominates(check1, i1));
+    REQUIRE(!g.instr_dominates(check1, check3));
+    REQUIRE(!g.instr_dominates(check2, check4));
+    REQUIRE(g.instr_dominates(c0, check4));
+    REQUIRE(g.instr_dominates(check4, i5));
+    REQUIRE(!g.instr_dominates(check5, check4));
+
 
     std::cerr << g.dump();
     doCheckElimination(g);
     std::cerr << g.dump();
 
-}
\ No newline at end of file
+}
+TEST_CASE("Test compact", "[compact1]") {
+    IR::BbGraph g{};
+    IR::BasicBlockManager bbs{};
+    IR::InstrManager instrs{};
+
+    auto *bb1 = bbs.create();
+    auto *bb2 = bbs.create();
+    auto *bb3 = bbs.create();
+    auto *bb4 = bbs.create();
+    auto *i1 = instrs.createADD({});
+    auto *i2 = instrs.createADD({});
+    bb3->push_instrs({i1});
+    bb4->push_instrs({i2});
+
+    REQUIRE(g.add_node(*bb1) != G::KEY_UNDEF);
+    REQUIRE(g.add_node(*bb2) != G::KEY_UNDEF);
+    REQUIRE(g.add_node(*bb3) != G::KEY_UNDEF);
+    REQUIRE(g.add_node(*bb4) != G::KEY_UNDEF);
+    REQUIRE(g.add_edge(0, 1, 2) != G::KEY_UNDEF);
+    REQUIRE(g.add_edge(0, 2, 3) != G::KEY_UNDEF);
+    REQUIRE(g.add_edge(0, 3, 4) != G::KEY_UNDEF);
+    REQUIRE(g.add_edge(0, 4, 3) != G::KEY_UNDEF);
+    REQUIRE(g.delete_node(1) != G::KEY_UNDEF);
+    REQUIRE(g.setHeader(3) != G::KEY_UNDEF);
+    g.at(4)->set_loop(3);
+
+    auto keys = g.compact();
+    REQUIRE(keys == G::KeyMapT{{2, 1}, {3, 2}, {4, 3}});
+    REQUIRE(bb2->get_id() == 1);
+    REQUIRE(bb3->get_id() == 2);
+    REQUIRE(bb4->get_id() == 3);
+    REQUIRE(g.accessHeader()->data().get_id() == 2);
+    REQUIRE(g.at(3)->get_loop() == 2);
+    REQUIRE(g.get_edge_id(1, 2) == 1);
+    REQUIRE(g.get_edge_id(3, 2) == 3);
+    REQUIRE(g.get_avail_nd_key() == 4);
+    REQUIRE(g.instr_dominates(i1, i2));
+    REQUIRE(g.RPO(2) == std::vector<G::key_t>{2, 3});
+    REQUIRE(g.delete_node(2) != G::KEY_UNDEF);
+    REQUIRE(g.at(1)->get_successor_count() == 0);
+}
+
+TEST_CASE("Test dominance frontier", "[domfront1]") {
+    // diamond 1 -> 2 -> 3 -> 5, 1 -> 4 -> 5 as in checkElimination CFG
+    IR::BbGraph g{};
+    IR::BasicBlockManager bbs{};
+    for (int i = 0; i < 5; ++i) {
+        REQUIRE(g.add_node(*bbs.create()) != G::KEY_UNDEF);
+    }
+    REQUIRE(g.setHeader(1) != G::KEY_UNDEF);
+    REQUIRE(g.add_edge(0, 1, 2) != G::KEY_UNDEF);
+    REQUIRE(g.add_edge(0, 2, 3) != G::KEY_UNDEF);
+    REQUIRE(g.add_edge(0, 1, 4) != G::KEY_UNDEF);
+    REQUIRE(g.add_edge(0, 4, 5) != G::KEY_UNDEF);
+    REQUIRE(g.add_edge(0, 3, 5) != G::KEY_UNDEF);
+
+    REQUIRE(g.dom_frontier(1).empty());
+    REQUIRE(g.dom_frontier(2) == std::vector<G::key_t>{5});
+    REQUIRE(g.dom_frontier(3) == std::vector<G::key_t>{5});
+    REQUIRE(g.dom_frontier(4) == std::vector<G::key_t>{5});
+    REQUIRE(g.phi_blocks({3, 4}) == std::vector<G::key_t>{5});
+
+    // loop back to 2 from 5
+    REQUIRE(g.add_edge(0, 5, 2) != G::KEY_UNDEF);
+    REQUIRE(g.dom_frontier(3) == std::vector<G::key_t>{5});
+    REQUIRE(g.dom_frontier(5) == std::vector<G::key_t>{2});
+    REQUIRE(g.phi_blocks({3}) == std::vector<G::key_t>{2, 5});
+}
+
+TEST_CASE("Test loop tree", "[loops1]") {
+    // 1 -> 2 -> 3 -> 2 (inner), 3 -> 4 -> 2 (outer), 4 -> 5
+    IR::BbGraph g{};
+    IR::BasicBlockManager bbs{};
+    for (int i = 0; i < 5; ++i) {
+        REQUIRE(g.add_node(*bbs.create()) != G::KEY_UNDEF);
+    }
+    REQUIRE(g.setHeader(1) != G::KEY_UNDEF);
+    REQUIRE(g.add_edge(0, 1, 2) != G::KEY_UNDEF);
+    REQUIRE(g.add_edge(0, 2, 3) != G::KEY_UNDEF);
+    REQUIRE(g.add_edge(0, 3, 2) != G::KEY_UNDEF);
+    REQUIRE(g.add_edge(0, 3, 4) != G::KEY_UNDEF);
+    REQUIRE(g.add_edge(0, 4, 2) != G::KEY_UNDEF);
+    REQUIRE(g.add_edge(0, 4, 5) != G::KEY_UNDEF);
+
+    G::Graph<G::Cycle, int> loops{};
+    std::vector<G::Cycle> cycles{};
+    Analysis::buildLoopTree(&g, &loops, cycles, 1);
+    REQUIRE(g.at(1)->get_loop() == G::KEY_UNDEF);
+    REQUIRE(g.at(2)->get_loop() == 2);
+    REQUIRE(g.at(3)->get_loop() == 2);
+    REQUIRE(g.at(4)->get_loop() == 2);
+    REQUIRE(g.at(5)->get_loop() == G::KEY_UNDEF);
+    // both back edges go to 2: one reducible loop
+    REQUIRE(loops.get_node_count() == 2);
+    REQUIRE(loops.at(2)->data().is_reducible);
+    REQUIRE(loops.at(2)->data().blocks == std::vector<G::key_t>{2, 3, 4});
+
+    REQUIRE(g.loop_depth(3) == 1);
+    REQUIRE(g.loop_depth(5) == 0);
+    REQUIRE(g.loop_header(4) == 2);
+    REQUIRE(g.latches(2) == std::vector<G::key_t>{3, 4});
+    REQUIRE(g.loop_exits(2) == std::vector<G::EdgeEndsT>{{4, 5}});
+    REQUIRE(g.preheader(2) == 1);
+    REQUIRE(g.nearest_common_dominator(3, 4) == 3);
+    REQUIRE(g.nearest_common_dominator(5, 3) == 3);
+    // 1 branches now: no preheader until the edge is split
+    REQUIRE(g.add_edge(0, 1, 5) != G::KEY_UNDEF);
+    REQUIRE(g.preheader(2) == G::KEY_UNDEF);
+}
+
+TEST_CASE("Test loop simplify", "[loops2]") {
+    // loop 3 <-> {4, 5} entered from 1 & 2, exit 4 -> 6 shared w/ 2 -> 6
+    IR::BbGraph g{};
+    IR::BasicBlockManager bbs{};
+    IR::InstrManager instrs{};
+    std::vector<IR::BasicBlock *> bb{nullptr};
+    for (int i = 1; i <= 6; ++i) {
+        bb.push_back(bbs.create());
+        REQUIRE(g.add_node(*bb.back()) != G::KEY_UNDEF);
+    }
+    auto *c0 = instrs.createCONST(IR::ValueHolder(1, IR::NO_VALUEHOLDER));
+    auto *c1 = instrs.createCONST(IR::ValueHolder(2, IR::NO_VALUEHOLDER));
+    auto *i2 = instrs.createADD({});
+    i2->push_inputs({c0, c0});
+    auto *h = instrs.create();
+    auto *i4 = instrs.createADD({});
+    i4->push_inputs({h, c0});
+    auto *i5 = instrs.createADD({});
+    i5->push_inputs({h, c1});
+    auto *e = instrs.create();
+    h->push_inputs({c1, i2, i4, i5});
+    e->push_inputs({i2, i4});
+    bb[1]->push_instrs({c0, c1});
+    bb[2]->push_instrs({i2});
+    bb[3]->push_phys({h});
+    bb[4]->push_instrs({i4});
+    bb[5]->push_instrs({i5});
+    bb[6]->push_phys({e});
+    REQUIRE(g.setHeader(1) != G::KEY_UNDEF);
+    for (auto edge : std::vector<G::EdgeEndsT>{{1, 2}, {1, 3}, {2, 3}, {2, 6}, {3, 4}, {3, 5},
+                                               {4, 3}, {5, 3}, {4, 6}}) {
+        REQUIRE(g.add_edge(0, edge.first, edge.second) != G::KEY_UNDEF);
+    }
+    REQUIRE(g.preheader(3) == G::KEY_UNDEF);
+    REQUIRE(g.latches(3) == std::vector<G::key_t>{4, 5});
+
+    // not a pred of 6 / duplicate pred: nothing changes
+    REQUIRE(splitPredecessors(g, 6, {2, 1}, bbs, instrs) == G::KEY_UNDEF);
+    REQUIRE(splitPredecessors(g, 6, {2, 2}, bbs, instrs) == G::KEY_UNDEF);
+    REQUIRE(g.get_node_count() == 6);
+    REQUIRE(g.get_edge_id(2, 6) != G::KEY_UNDEF);
+
+    REQUIRE(doLoopSimplify(g, bbs, instrs));
+    g.throwIfNotConsistent();
+    instrs.throwIfNotConsistent_();
+    // 7: preheader, 8: latch, 9: dedicated exit
+    REQUIRE(g.get_node_count() == 9);
+    REQUIRE(g.preheader(3) == 7);
+    REQUIRE(g.latches(3) == std::vector<G::key_t>{8});
+    REQUIRE(g.loop_exits(3) == std::vector<G::EdgeEndsT>{{4, 9}});
+    REQUIRE(g.at(6)->get_predecessor_count() == 2);
+    REQUIRE(g.get_edge_id(2, 6) != G::KEY_UNDEF);
+    REQUIRE(g.get_edge_id(9, 6) != G::KEY_UNDEF);
+
+    // header phy merges entry values in preheader & back edge values in latch
+    auto &pre = g.at(7)->data();
+    auto &latch = g.at(8)->data();
+    REQUIRE(pre.phy_begin() != pre.phy_end());
+    REQUIRE(latch.phy_begin() != latch.phy_end());
+    auto *pre_phy = *pre.phy_begin();
+    auto *latch_phy = *latch.phy_begin();
+    auto inputs = [](IR::InstrBase *instr) {
+        return std::vector<IR::InstrBase *>(instr->inputs_begin(), instr->inputs_end());
+    };
+    REQUIRE(inputs(h) == std::vector<IR::InstrBase *>{pre_phy, latch_phy});
+    REQUIRE(inputs(pre_phy) == std::vector<IR::InstrBase *>{c1, i2});
+    REQUIRE(inputs(latch_phy) == std::vector<IR::InstrBase *>{i4, i5});
+    // single value comes through dedicated exit, exit phy is untouched
+    REQUIRE(g.at(9)->data().phy_begin() == g.at(9)->data().phy_end());
+    REQUIRE(inputs(e) == std::vector<IR::InstrBase *>{i2, i4});
+
+    // already canonical
+    REQUIRE(doLoopSimplify(g, bbs, instrs));
+    REQUIRE(g.get_node_count() == 9);
+}
+
+TEST_CASE("Test bb graph builder", "[build1]") {
+    // 2 -> 3 -> 4 -> 3, 4 -> 5 built at once; node keys default to bb ids
+    IR::BasicBlock detached{};
+    IR::BbGraph g{};
+    IR::BasicBlockManager bbs{};
+    bbs.create();
+    G::GraphBuilder<IR::BasicBlock, int> builder{};
+    builder.reserve(5, 4);
+    for (int i = 0; i < 4; ++i) {
+        auto *bb = bbs.create();
+        REQUIRE(builder.add_node(*bb) == bb->get_id());
+    }
+    // bb w/o id gets the next free key & takes it as id
+    REQUIRE(builder.add_node(detached) == 6);
+    builder.add_edge(0, 2, 3);
+    builder.add_edge(0, 3, 4);
+    builder.add_edge(0, 4, 3);
+    builder.add_edge(0, 4, 5);
+    REQUIRE(builder.build(g) == 6);
+    REQUIRE(detached.get_id() == 6);
+    for (auto it = g.nodes_begin(); it != g.nodes_end(); ++it) {
+        REQUIRE(it->second->data().get_id() == it->first);
+    }
+    REQUIRE(g.setHeader(2) != G::KEY_UNDEF);
+    REQUIRE(g.loop_header(4) == 3);
+    REQUIRE(g.preheader(3) == 2);
+    REQUIRE(g.nearest_common_dominator(5, 3) == 3);
+}
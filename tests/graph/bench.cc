@@ -0,0 +1,148 @@
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+#include "graph.hpp"
+#include "graphBuilder.hpp"
+#include "loopForest.hpp"
+#include <chrono>
+
+namespace {
+// chain 1 -> 2 -> ... -> n with extra pseudo-random forward/back edges
+void fillGraph(G::Graph<int, int> &g, G::key_t node_count) {
+    int value{0};
+    REQUIRE(g.add_nodes(value, node_count) != G::KEY_UNDEF);
+    for (G::key_t i = 1; i < node_count; ++i) {
+        g.add_edge(0, i, i + 1);
+        g.add_edge(0, i, (i * 7919) % node_count + 1);
+    }
+}
+
+long long elapsedMs(std::chrono::steady_clock::time_point start) {
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+}
+} // namespace
+
+TEST_CASE("Bench delete nodes", "[bench_delete]") {
+    constexpr G::key_t node_count = 100000;
+    G::Graph<int, int> g{};
+    fillGraph(g, node_count);
+
+    auto start = std::chrono::steady_clock::now();
+    size_t deleted{0};
+    for (G::key_t key = 10; key <= node_count; key += 10) {
+        deleted += (g.delete_node(key) != G::KEY_UNDEF);
+    }
+    std::cout << "delete " << deleted << " of " << node_count << " nodes: " << elapsedMs(start)
+              << " ms" << std::endl;
+
+    REQUIRE(deleted == node_count / 10);
+    REQUIRE(g.get_node_count() == node_count - deleted);
+    // no dangling adjacency left behind
+    for (auto it = g.nodes_begin(); it != g.nodes_end(); ++it) {
+        auto *node = it->second;
+        for (auto succ = node->successors_begin(); succ != node->successors_end(); ++succ) {
+            REQUIRE(succ->first % 10 != 0);
+        }
+        for (auto pred = node->predecessors_begin(); pred != node->predecessors_end(); ++pred) {
+            REQUIRE(pred->first % 10 != 0);
+        }
+        REQUIRE(node->out_edges().size() == node->get_successor_count());
+        REQUIRE(node->in_edges().size() == node->get_predecessor_count());
+    }
+}
+
+TEST_CASE("Bench loop forest", "[bench_loops]") {
+    constexpr G::key_t node_count = 100000;
+    G::Graph<int, int> g{};
+    fillGraph(g, node_count);
+    G::CsrGraph view = g.freeze();
+
+    auto start = std::chrono::steady_clock::now();
+    G::LoopForest forest{};
+    forest.build(view.index(1), view);
+    std::cout << "loop forest of " << node_count << " nodes, " << forest.headers().size()
+              << " loops: " << elapsedMs(start) << " ms" << std::endl;
+    REQUIRE(!forest.headers().empty());
+}
+
+TEST_CASE("Bench scc", "[bench_scc]") {
+    // single cycle through all nodes: DFS depth equals node count
+    constexpr G::key_t node_count = 1000000;
+    std::vector<G::key_t> keys(node_count);
+    std::vector<G::CsrGraph::EdgeT> edges{};
+    edges.reserve(node_count);
+    for (G::key_t i = 0; i < node_count; ++i) {
+        keys[i] = i + 1;
+        edges.push_back({i + 1, (i + 1) % node_count + 1, i + 1});
+    }
+    G::CsrGraph view{};
+    view.build(keys, edges);
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<G::idx_t> component{};
+    G::idx_t count = view.SCC(component);
+    std::cout << "scc of " << node_count << " nodes: " << elapsedMs(start) << " ms" << std::endl;
+    REQUIRE(count == 1);
+    REQUIRE(component.front() == component.back());
+}
+
+TEST_CASE("Bench reachability", "[bench_reach]") {
+    // acyclic: chain w/ short forward jumps, so no SCC collapses it
+    constexpr G::key_t node_count = 100000;
+    G::Graph<int, int> g{};
+    int value{0};
+    REQUIRE(g.add_nodes(value, node_count) != G::KEY_UNDEF);
+    for (G::key_t i = 1; i < node_count; ++i) {
+        g.add_edge(0, i, i + 1);
+        g.add_edge(0, i, std::min(node_count, i + (i * 7919) % 64 + 2));
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    const G::Reachability &index = g.reachability();
+    std::cout << "reachability of " << node_count << " nodes: " << elapsedMs(start) << " ms"
+              << std::endl;
+    REQUIRE(!index.is_bitset());
+
+    start = std::chrono::steady_clock::now();
+    size_t found{0};
+    constexpr G::key_t query_count = 1000000;
+    for (G::key_t i = 0; i < query_count; ++i) {
+        G::key_t a = (i * 7919) % node_count + 1;
+        G::key_t b = (i * 104729) % node_count + 1;
+        found += g.reachable(a, b);
+    }
+    std::cout << query_count << " reachability queries: " << elapsedMs(start) << " ms"
+              << std::endl;
+    REQUIRE(g.reachable(1, node_count));
+    REQUIRE(!g.reachable(node_count, 1));
+    REQUIRE(found > 0);
+}
+
+TEST_CASE("Bench graph builder", "[bench_build]") {
+    constexpr G::key_t node_count = 100000;
+    int value{0};
+    auto start = std::chrono::steady_clock::now();
+    G::Graph<int, int> g{};
+    fillGraph(g, node_count);
+    std::cout << "add_edge build of " << node_count << " nodes: " << elapsedMs(start) << " ms"
+              << std::endl;
+
+    start = std::chrono::steady_clock::now();
+    G::GraphBuilder<int, int> builder{};
+    builder.reserve(node_count, 2 * node_count);
+    for (G::key_t i = 1; i <= node_count; ++i) {
+        builder.add_node(value);
+    }
+    for (G::key_t i = 1; i < node_count; ++i) {
+        builder.add_edge(0, i, i + 1);
+        G::key_t jump = (i * 7919) % node_count + 1;
+        if (jump != i + 1) {
+            builder.add_edge(0, i, jump);
+        }
+    }
+    G::Graph<int, int> built{};
+    REQUIRE(builder.build(built) == node_count);
+    std::cout << "bulk build of " << node_count << " nodes: " << elapsedMs(start) << " ms"
+              << std::endl;
+    REQUIRE(built.dump() == g.dump());
+}
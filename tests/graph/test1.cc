@@ -1,7 +1,9 @@
 #define CATCH_CONFIG_MAIN
 #include "catch.hpp"
 #include "graph.hpp"
+#include "graphBuilder.hpp"
 #include "LoopTreeBuilder.hpp"
+#include <random>
 
 TEST_CASE("Test API 1", "[graph1]") {
     G::Graph<int, int> g{};
@@ -86,6 +88,38 @@ TEST_CASE("Test API 4", "[graph4]") {
     std::cerr << d.dump();
 }
 
+TEST_CASE("Test edge index", "[graph5]") {
+    G::Graph<int, int> d{};
+    int value{10};
+
+    REQUIRE(d.add_nodes(value, 4) != G::KEY_UNDEF);
+    G::key_t e12 = d.add_edge(10, 1, 2);
+    G::key_t e23 = d.add_edge(10, 2, 3);
+    G::key_t e34 = d.add_edge(10, 3, 4);
+    G::key_t e41 = d.add_edge(10, 4, 1);
+    REQUIRE(d.get_edge_id(1, 2) == e12);
+    REQUIRE(d.get_edge_id(2, 3) == e23);
+    REQUIRE(d.get_edge_id(4, 1) == e41);
+    REQUIRE(d.get_edge_id(2, 1) == G::KEY_UNDEF);
+
+    REQUIRE(d.cut_edge(2, 3) == e23);
+    REQUIRE(d.get_edge_id(2, 3) == G::KEY_UNDEF);
+    REQUIRE(d.cut_node(4) != G::KEY_UNDEF);
+    REQUIRE(d.get_edge_id(3, 4) == G::KEY_UNDEF);
+    REQUIRE(d.paste_all() != G::KEY_UNDEF);
+    REQUIRE(d.get_edge_id(2, 3) == e23);
+    REQUIRE(d.get_edge_id(3, 4) == e34);
+    REQUIRE(d.get_edge_id(4, 1) == e41);
+
+    REQUIRE(d.delete_edge(3, 4) == e34);
+    REQUIRE(d.get_edge_id(3, 4) == G::KEY_UNDEF);
+    REQUIRE(d.add_edge(10, 3, 4) != G::KEY_UNDEF);
+    REQUIRE(d.get_edge_id(3, 4) != e34);
+    REQUIRE(d.delete_node(1) != G::KEY_UNDEF);
+    REQUIRE(d.get_edge_id(4, 1) == G::KEY_UNDEF);
+    REQUIRE(d.get_edge_id(2, 3) == e23);
+}
+
 /*
     DFS & RPO test #1
           ┌───┐
@@ -118,6 +152,78 @@ TEST_CASE("Test API 4", "[graph4]") {
 
 */
 
+TEST_CASE("Test small vector", "[graph6]") {
+    G::SmallVector<int, 2> vec{};
+    vec.push_back(3);
+    vec.push_back(1);
+    REQUIRE(vec.is_inline());
+    vec.insert(vec.begin() + 1, 2);
+    REQUIRE(!vec.is_inline());
+    REQUIRE(std::vector<int>(vec.begin(), vec.end()) == std::vector<int>{3, 2, 1});
+    G::SmallVector<int, 2> copy{vec};
+    G::SmallVector<int, 2> moved{std::move(vec)};
+    REQUIRE(vec.empty());
+    moved.erase(moved.begin());
+    REQUIRE(std::vector<int>(moved.begin(), moved.end()) == std::vector<int>{2, 1});
+    REQUIRE(std::vector<int>(copy.begin(), copy.end()) == std::vector<int>{3, 2, 1});
+
+    // hub node spills its adjacency to heap, neighbours stay sorted by key
+    G::Graph<int, int> g{};
+    int value{10};
+    REQUIRE(g.add_nodes(value, 8) != G::KEY_UNDEF);
+    for (G::key_t key : {5, 2, 8, 3, 7, 4, 6}) {
+        REQUIRE(g.add_edge(0, 1, key) != G::KEY_UNDEF);
+        REQUIRE(g.add_edge(0, key, 1) != G::KEY_UNDEF);
+    }
+    REQUIRE(g.add_edge(0, 1, 4) == G::KEY_DUBLICATE);
+    REQUIRE(g.delete_edge(1, 6) != G::KEY_UNDEF);
+    REQUIRE(g.delete_edge(1, 6) == G::KEY_UNDEF);
+    std::vector<G::key_t> succs{};
+    for (auto it = g.at(1)->successors_begin(); it != g.at(1)->successors_end(); ++it) {
+        REQUIRE(it->second->get_key() == it->first);
+        succs.push_back(it->first);
+    }
+    REQUIRE(succs == std::vector<G::key_t>{2, 3, 4, 5, 7, 8});
+    REQUIRE(g.at(1)->get_predecessor_count() == 7);
+    REQUIRE(g.delete_node(1) != G::KEY_UNDEF);
+    REQUIRE(g.at(6)->get_successor_count() == 0);
+}
+
+TEST_CASE("Test compact", "[graph7]") {
+    G::Graph<int, int> g{};
+    int value{10};
+    REQUIRE(g.add_nodes(value, 6) != G::KEY_UNDEF);
+    REQUIRE(g.add_edge(0, 1, 3) != G::KEY_UNDEF);
+    REQUIRE(g.add_edge(0, 3, 5) != G::KEY_UNDEF);
+    REQUIRE(g.add_edge(0, 5, 1) != G::KEY_UNDEF);
+    REQUIRE(g.add_edge(0, 5, 6) != G::KEY_UNDEF);
+    REQUIRE(g.delete_node(2) != G::KEY_UNDEF);
+    REQUIRE(g.delete_node(4) != G::KEY_UNDEF);
+    REQUIRE(g.delete_edge(5, 6) != G::KEY_UNDEF);
+    auto dfs = g.DFS(1);
+
+    REQUIRE(g.cut_node(6) != G::KEY_UNDEF);
+    REQUIRE(g.compact().empty());
+    REQUIRE(g.paste_all() != G::KEY_UNDEF);
+
+    auto keys = g.compact();
+    REQUIRE(keys == G::KeyMapT{{1, 1}, {3, 2}, {5, 3}, {6, 4}});
+    REQUIRE(g.get_node_count() == 4);
+    REQUIRE(g.get_avail_nd_key() == 5);
+    REQUIRE(g.get_avail_edg_key() == 4);
+    for (auto &key : dfs) {
+        key = keys.at(key);
+    }
+    REQUIRE(g.DFS(1) == dfs);
+    REQUIRE(g.get_edge_id(1, 2) == 1);
+    REQUIRE(g.get_edge_id(3, 1) == 3);
+    REQUIRE(g.at(3)->get_key() == 3);
+    REQUIRE(g.add_node(value) == 5);
+    REQUIRE(g.add_edge(0, 3, 5) == 4);
+    REQUIRE(g.delete_node(1) != G::KEY_UNDEF);
+    REQUIRE(g.at(3)->get_successor_count() == 1);
+}
+
 TEST_CASE("Test DFS", "[DFS1]") {
 
     G::Graph<int, int> g{};
@@ -148,6 +254,147 @@ TEST_CASE("Test DFS", "[DFS1]") {
     std::cerr << "\n";
 }
 
+TEST_CASE("Test DFS visitor", "[DFS2]") {
+    // deep chain 1 -> ... -> n with back edge n -> 1: recursion would overflow here
+    constexpr G::key_t node_count = 200000;
+    G::Graph<int, int> g{};
+    int value{10};
+    REQUIRE(g.add_nodes(value, node_count) != G::KEY_UNDEF);
+    for (G::key_t i = 1; i < node_count; ++i) {
+        REQUIRE(g.add_edge(0, i, i + 1) != G::KEY_UNDEF);
+    }
+    REQUIRE(g.add_edge(0, node_count, 1) != G::KEY_UNDEF);
+
+    std::vector<G::key_t> preorder{42};
+    g.DFS(1, preorder);
+    REQUIRE(preorder.size() == node_count);
+    REQUIRE(preorder.front() == 1);
+    REQUIRE(preorder.back() == node_count);
+    REQUIRE(g.hasPath(1, node_count));
+    REQUIRE(g.hasPath(node_count, node_count - 1));
+
+    struct Counter : G::DfsVisitor<int, int> {
+        bool pre(G::Node<int, int> &) {
+            ++pre_count;
+            return true;
+        }
+        void post(G::Node<int, int> &node) { post_order.push_back(node.get_key()); }
+        void back_edge(G::Node<int, int> &from, G::Node<int, int> &to) {
+            back_edges.emplace_back(from.get_key(), to.get_key());
+        }
+        size_t pre_count{0};
+        std::vector<G::key_t> post_order{};
+        std::vector<std::pair<G::key_t, G::key_t>> back_edges{};
+    };
+    Counter counter{};
+    g.DFS_visit(1, counter);
+    REQUIRE(counter.pre_count == node_count);
+    REQUIRE(counter.post_order.front() == node_count);
+    REQUIRE(counter.post_order.back() == 1);
+    REQUIRE(counter.back_edges.size() == 1);
+    REQUIRE(counter.back_edges[0] == std::make_pair(node_count, G::key_t{1}));
+
+    auto cycles = g.get_cycles(1, G::KEY_UNDEF);
+    REQUIRE(cycles.size() == 1);
+    REQUIRE(cycles[0].head_node == 1);
+    REQUIRE(cycles[0].back_edge_start == node_count);
+    REQUIRE(cycles[0].is_reducible);
+}
+
+TEST_CASE("Test DFS keeps colors", "[DFS3]") {
+    G::Graph<int, int> g{};
+    int value{10};
+    REQUIRE(g.add_nodes(value, 3) != G::KEY_UNDEF);
+    REQUIRE(g.add_edge(0, 1, 2) != G::KEY_UNDEF);
+    REQUIRE(g.add_edge(0, 2, 3) != G::KEY_UNDEF);
+    REQUIRE(g.add_edge(0, 3, 2) != G::KEY_UNDEF);
+    g.at(2)->set_color(G::ColorT::GRAY);
+    g.at(3)->set_color(G::ColorT::BLACK);
+
+    REQUIRE(g.DFS(1) == std::vector<G::key_t>{1, 2, 3});
+    REQUIRE(g.hasPath(1, 3));
+    REQUIRE(g.get_cycles(1, G::KEY_UNDEF).size() == 1);
+    REQUIRE(g.at(1)->get_color() == G::ColorT::WHITE);
+    REQUIRE(g.at(2)->get_color() == G::ColorT::GRAY);
+    REQUIRE(g.at(3)->get_color() == G::ColorT::BLACK);
+}
+
+TEST_CASE("Test RPO", "[RPO1]") {
+    // 1 -> 2 -> 4, 1 -> 3 -> 4, 4 -> 1
+    G::Graph<int, int> g{};
+    int value{10};
+    REQUIRE(g.add_nodes(value, 4) != G::KEY_UNDEF);
+    REQUIRE(g.add_edge(0, 1, 2) != G::KEY_UNDEF);
+    REQUIRE(g.add_edge(0, 1, 3) != G::KEY_UNDEF);
+    REQUIRE(g.add_edge(0, 2, 4) != G::KEY_UNDEF);
+    REQUIRE(g.add_edge(0, 3, 4) != G::KEY_UNDEF);
+    REQUIRE(g.add_edge(0, 4, 1) != G::KEY_UNDEF);
+
+    const auto &rpo = g.RPO(1);
+    REQUIRE(rpo == std::vector<G::key_t>{1, 3, 2, 4});
+    size_t mod_count = g.get_mod_count();
+    REQUIRE(&g.RPO(1) == &rpo);
+    REQUIRE(g.get_mod_count() == mod_count);
+
+    REQUIRE(g.delete_edge(3, 4) != G::KEY_UNDEF);
+    REQUIRE(g.get_mod_count() != mod_count);
+    REQUIRE(g.RPO(1) == std::vector<G::key_t>{1, 3, 2, 4});
+    REQUIRE(g.add_edge(0, 2, 3) != G::KEY_UNDEF);
+    REQUIRE(g.RPO(1) == std::vector<G::key_t>{1, 2, 4, 3});
+    REQUIRE(g.RPO(2) == std::vector<G::key_t>{2, 4, 1, 3});
+}
+
+TEST_CASE("Test CSR view", "[CSR1]") {
+    // 1 -> 2 -> 4, 1 -> 3 -> 4, 4 -> 1, 5 unreachable
+    G::Graph<int, int> g{};
+    int value{10};
+    REQUIRE(g.add_nodes(value, 5) != G::KEY_UNDEF);
+    REQUIRE(g.add_edge(0, 1, 2) != G::KEY_UNDEF);
+    REQUIRE(g.add_edge(0, 1, 3) != G::KEY_UNDEF);
+    REQUIRE(g.add_edge(0, 2, 4) != G::KEY_UNDEF);
+    REQUIRE(g.add_edge(0, 3, 4) != G::KEY_UNDEF);
+    REQUIRE(g.add_edge(0, 4, 1) != G::KEY_UNDEF);
+    REQUIRE(g.add_edge(0, 5, 4) != G::KEY_UNDEF);
+
+    G::CsrGraph view = g.freeze();
+    REQUIRE(view.size() == 5);
+    REQUIRE(view.edge_count() == 6);
+    auto idx = [&view](G::key_t key) { return view.index(key); };
+    auto keys = [&view](const std::vector<G::idx_t> &vec) {
+        std::vector<G::key_t> res{};
+        for (auto node : vec) {
+            res.push_back(view.key(node));
+        }
+        return res;
+    };
+    REQUIRE(view.index(42) == G::IDX_UNDEF);
+    REQUIRE(view.get_successor_count(idx(1)) == 2);
+    REQUIRE(view.get_predecessor_count(idx(4)) == 3);
+    REQUIRE(view.out_edges_begin(idx(4))[0] == g.get_edge_id(4, 1));
+
+    std::vector<G::idx_t> buf{};
+    view.DFS(idx(1), buf);
+    REQUIRE(keys(buf) == g.DFS(1));
+    view.RPO(idx(1), buf);
+    REQUIRE(keys(buf) == g.RPO(1));
+    REQUIRE(view.hasPath(idx(5), idx(3)));
+    REQUIRE(!view.hasPath(idx(1), idx(5)));
+    std::vector<std::pair<G::idx_t, G::idx_t>> back{};
+    view.back_edges(idx(1), back);
+    REQUIRE(back.size() == 1);
+    REQUIRE(back[0] == std::make_pair(idx(4), idx(1)));
+
+    G::DomTree tree{};
+    tree.build(idx(1), view);
+    REQUIRE(tree.idom(idx(4)) == idx(1));
+    REQUIRE(!tree.reachable(idx(5)));
+
+    // snapshot is not affected by later changes
+    REQUIRE(g.delete_node(3) != G::KEY_UNDEF);
+    REQUIRE(view.size() == 5);
+    REQUIRE(view.hasPath(idx(1), idx(3)));
+}
+
 TEST_CASE("Test dom search", "[DOM1]") {
     G::Graph<int, int> g{};
     int value{10};
@@ -429,6 +676,258 @@ TEST_CASE("Test dom tree 3", "[DOM_TREE_3]") {
     std::cerr << domTree.dump();
 }
 
+// same CFG as DOM_TREE_3
+TEST_CASE("Test dom tree idoms", "[DOM_TREE_4]") {
+    G::Graph<int, int> g{};
+    int value{0};
+    REQUIRE(g.add_nodes(value, 10) != G::KEY_UNDEF);
+    REQUIRE(g.add_edge(0, 1, 2) != G::KEY_UNDEF);
+    REQUIRE(g.add_edge(0, 2, 3) != G::KEY_UNDEF);
+    REQUIRE(g.add_edge(0, 3, 4) != G::KEY_UNDEF);
+    REQUIRE(g.add_edge(0, 4, 7) != G::KEY_UNDEF);
+    REQUIRE(g.add_edge(0, 7, 9) != G::KEY_UNDEF);
+    REQUIRE(g.add_edge(0, 7, 3) != G::KEY_UNDEF);
+    REQUIRE(g.add_edge(0, 2, 5) != G::KEY_UNDEF);
+    REQUIRE(g.add_edge(0, 5, 6) != G::KEY_UNDEF);
+    REQUIRE(g.add_edge(0, 6, 8) != G::KEY_UNDEF);
+    REQUIRE(g.add_edge(0, 8, 7) != G::KEY_UNDEF);
+    REQUIRE(g.add_edge(0, 8, 9) != G::KEY_UNDEF);
+    REQUIRE(g.add_edge(0, 6, 2) != G::KEY_UNDEF);
+    REQUIRE(g.add_edge(0, 5, 4) != G::KEY_UNDEF);
+    // node 10 is unreachable
+    REQUIRE(g.add_edge(0, 10, 9) != G::KEY_UNDEF);
+
+    std::map<G::key_t, G::key_t> idoms{{1, G::KEY_UNDEF}, {2, 1}, {3, 2}, {4, 2}, {5, 2},
+                                       {6, 5}, {7, 2}, {8, 6}, {9, 2}, {10, G::KEY_UNDEF}};
+    for (auto &item : idoms) {
+        REQUIRE(g.get_idom(1, item.first) == item.second);
+    }
+    auto dominated = g.getDominatedNodes(1, 5);
+    REQUIRE(std::set<G::key_t>(dominated.begin(), dominated.end()) ==
+            std::set<G::key_t>{5, 6, 8});
+    REQUIRE(dominated.front() == 5);
+    REQUIRE(g.getDominatedNodes(1, 10).empty());
+
+    // compare w/ definition: a dom b <=> b is unreachable from root w/o a
+    for (G::key_t a = 1; a <= 10; ++a) {
+        std::vector<bool> expected(11, false);
+        if (g.hasPath(1, a)) {
+            REQUIRE(g.cut_node(a) != G::KEY_UNDEF);
+            for (G::key_t b = 1; b <= 10; ++b) {
+                expected[b] = (b == a) || (g.node_exists(b) && !g.hasPath(1, b));
+            }
+            REQUIRE(g.paste_all() != G::KEY_UNDEF);
+            expected[10] = (a == 10);
+        }
+        for (G::key_t b = 1; b <= 10; ++b) {
+            REQUIRE(g.is_a_dominates_b(1, a, b) == (expected[b] && g.hasPath(1, b)));
+        }
+    }
+
+    // cache is dropped on graph change
+    REQUIRE(g.add_edge(0, 1, 8) != G::KEY_UNDEF);
+    REQUIRE(g.get_idom(1, 8) == 1);
+    REQUIRE(g.get_idom(1, 7) == 1);
+    REQUIRE(g.get_idom(1, 6) == 5);
+}
+
+TEST_CASE("Test dominance frontier", "[DOM_TREE_5]") {
+    // same CFG as DOM_TREE_4
+    G::Graph<int, int> g{};
+    int value{0};
+    REQUIRE(g.add_nodes(value, 10) != G::KEY_UNDEF);
+    REQUIRE(g.add_edge(0, 1, 2) != G::KEY_UNDEF);
+    REQUIRE(g.add_edge(0, 2, 3) != G::KEY_UNDEF);
+    REQUIRE(g.add_edge(0, 3, 4) != G::KEY_UNDEF);
+    REQUIRE(g.add_edge(0, 4, 7) != G::KEY_UNDEF);
+    REQUIRE(g.add_edge(0, 7, 9) != G::KEY_UNDEF);
+    REQUIRE(g.add_edge(0, 7, 3) != G::KEY_UNDEF);
+    REQUIRE(g.add_edge(0, 2, 5) != G::KEY_UNDEF);
+    REQUIRE(g.add_edge(0, 5, 6) != G::KEY_UNDEF);
+    REQUIRE(g.add_edge(0, 6, 8) != G::KEY_UNDEF);
+    REQUIRE(g.add_edge(0, 8, 7) != G::KEY_UNDEF);
+    REQUIRE(g.add_edge(0, 8, 9) != G::KEY_UNDEF);
+    REQUIRE(g.add_edge(0, 6, 2) != G::KEY_UNDEF);
+    REQUIRE(g.add_edge(0, 5, 4) != G::KEY_UNDEF);
+    REQUIRE(g.add_edge(0, 10, 9) != G::KEY_UNDEF);
+
+    // compare w/ definition: b in DF(a) <=> a dom some pred of b && !(a sdom b)
+    auto check = [&g]() {
+        for (G::key_t a = 1; a <= 10; ++a) {
+            std::set<G::key_t> expected{};
+            for (G::key_t b = 1; b <= 10; ++b) {
+                bool strict = (a != b) && g.is_a_dominates_b(1, a, b);
+                for (auto it = g.at(b)->predecessors_begin(); it != g.at(b)->predecessors_end();
+                     ++it) {
+                    if (g.is_a_dominates_b(1, a, it->first) && !strict) {
+                        expected.insert(b);
+                    }
+                }
+            }
+            auto df = g.get_dom_frontier(1, a);
+            REQUIRE(std::set<G::key_t>(df.begin(), df.end()) == expected);
+            REQUIRE(df.size() == expected.size());
+        }
+    };
+    check();
+    REQUIRE(g.get_dom_frontier(1, 6) == std::vector<G::key_t>{2, 7, 9});
+    REQUIRE(g.get_iterated_dom_frontier(1, {8}) == std::vector<G::key_t>{3, 4, 7, 9});
+    REQUIRE(g.get_iterated_dom_frontier(1, {1, 10}).empty());
+
+    // cache is dropped on graph change
+    REQUIRE(g.add_edge(0, 1, 8) != G::KEY_UNDEF);
+    check();
+    REQUIRE(g.get_dom_frontier(1, 6) == std::vector<G::key_t>{2, 8});
+
+    // loop header is the entry: single back edge is enough for a join
+    G::Graph<int, int> loop{};
+    REQUIRE(loop.add_nodes(value, 2) != G::KEY_UNDEF);
+    REQUIRE(loop.add_edge(0, 1, 2) != G::KEY_UNDEF);
+    REQUIRE(loop.add_edge(0, 2, 1) != G::KEY_UNDEF);
+    REQUIRE(loop.get_dom_frontier(1, 2) == std::vector<G::key_t>{1});
+    REQUIRE(loop.get_dom_frontier(1, 1) == std::vector<G::key_t>{1});
+    REQUIRE(loop.get_iterated_dom_frontier(1, {2}) == std::vector<G::key_t>{1});
+}
+
+TEST_CASE("Test post dom tree", "[DOM_TREE_6]") {
+    // two exits: 6 & 7; loop 4 <-> 5
+    G::Graph<int, int> g{};
+    int value{0};
+    REQUIRE(g.add_nodes(value, 7) != G::KEY_UNDEF);
+    REQUIRE(g.add_edge(0, 1, 2) != G::KEY_UNDEF);
+    REQUIRE(g.add_edge(0, 1, 3) != G::KEY_UNDEF);
+    REQUIRE(g.add_edge(0, 2, 4) != G::KEY_UNDEF);
+    REQUIRE(g.add_edge(0, 3, 4) != G::KEY_UNDEF);
+    REQUIRE(g.add_edge(0, 3, 7) != G::KEY_UNDEF);
+    REQUIRE(g.add_edge(0, 4, 5) != G::KEY_UNDEF);
+    REQUIRE(g.add_edge(0, 5, 4) != G::KEY_UNDEF);
+    REQUIRE(g.add_edge(0, 5, 6) != G::KEY_UNDEF);
+
+    std::map<G::key_t, G::key_t> ipdoms{{1, G::KEY_UNDEF}, {2, 4}, {3, G::KEY_UNDEF}, {4, 5},
+                                        {5, 6}, {6, G::KEY_UNDEF}, {7, G::KEY_UNDEF}};
+    for (auto &item : ipdoms) {
+        REQUIRE(g.get_ipdom(item.first) == item.second);
+    }
+
+    // compare w/ definition: a pdom b <=> no exit is reachable from b w/o a
+    for (G::key_t a = 1; a <= 7; ++a) {
+        std::vector<bool> expected(8, false);
+        REQUIRE(g.cut_node(a) != G::KEY_UNDEF);
+        for (G::key_t b = 1; b <= 7; ++b) {
+            expected[b] = (b == a) || (g.node_exists(b) && !g.hasPath(b, 6) && !g.hasPath(b, 7) &&
+                                       b != 6 && b != 7);
+        }
+        REQUIRE(g.paste_all() != G::KEY_UNDEF);
+        for (G::key_t b = 1; b <= 7; ++b) {
+            REQUIRE(g.is_a_postdominates_b(a, b) == expected[b]);
+        }
+    }
+
+    std::map<G::key_t, std::set<G::key_t>> deps{{1, {}},     {2, {1}},    {3, {1}},   {4, {1, 3, 5}},
+                                                {5, {1, 3, 5}}, {6, {1, 3}}, {7, {3}}};
+    for (auto &item : deps) {
+        auto vec = g.get_control_dependences(item.first);
+        REQUIRE(std::set<G::key_t>(vec.begin(), vec.end()) == item.second);
+        REQUIRE(vec.size() == item.second.size());
+    }
+
+    // cache is dropped on graph change; node 8 never reaches an exit
+    REQUIRE(g.delete_edge(3, 7) != G::KEY_UNDEF);
+    REQUIRE(g.add_node(value) != G::KEY_UNDEF);
+    REQUIRE(g.add_edge(0, 8, 8) != G::KEY_UNDEF);
+    REQUIRE(g.add_edge(0, 2, 8) != G::KEY_UNDEF);
+    REQUIRE(g.get_ipdom(3) == 4);
+    REQUIRE(g.get_ipdom(8) == G::KEY_UNDEF);
+    REQUIRE(!g.is_a_postdominates_b(8, 8));
+    REQUIRE(g.get_control_dependences(4) == std::vector<G::key_t>{5});
+}
+
+TEST_CASE("Test incremental dom tree", "[DOM_TREE_7]") {
+    // random edge inserts/deletes; cached tree is updated in place & must match a fresh build
+    std::mt19937 rng{7};
+    for (int round = 0; round < 20; ++round) {
+        G::Graph<int, int> g{};
+        int value{0};
+        const G::key_t n = 30;
+        REQUIRE(g.add_nodes(value, n) != G::KEY_UNDEF);
+        std::uniform_int_distribution<G::key_t> pick{1, n};
+        for (int i = 0; i < 2 * n; ++i) {
+            g.add_edge(0, pick(rng), pick(rng));
+        }
+        size_t reached = g.dom_tree(1).size();
+        for (int step = 0; step < 200; ++step) {
+            size_t updates = g.dom_tree(1).updates();
+            G::key_t a = pick(rng);
+            G::key_t b = pick(rng);
+            if (g.get_edge_id(a, b) != G::KEY_UNDEF) {
+                REQUIRE(g.delete_edge(a, b) != G::KEY_UNDEF);
+            } else {
+                REQUIRE(g.add_edge(0, a, b) != G::KEY_UNDEF);
+            }
+            const G::DomTree &tree = g.dom_tree(1);
+            G::CsrGraph view = g.freeze();
+            G::DomTree expected{};
+            expected.build(view.index(1), view);
+            // reachable set only grows on insert & shrinks on delete: equal size - same set
+            if (expected.size() == reached) {
+                // updated in place, not rebuilt
+                REQUIRE(tree.updates() == updates + 1);
+            } else {
+                REQUIRE(tree.updates() == 0);
+            }
+            reached = expected.size();
+            REQUIRE(tree.size() == expected.size());
+            for (G::idx_t i = 0; i < view.size(); ++i) {
+                REQUIRE(tree.idom(i) == expected.idom(i));
+                REQUIRE(tree.depth(i) == expected.depth(i));
+            }
+            for (G::idx_t i = 0; i < view.size(); ++i) {
+                for (G::idx_t j = 0; j < view.size(); ++j) {
+                    REQUIRE(tree.dominates(i, j) == expected.dominates(i, j));
+                }
+            }
+        }
+        // frontiers are built over fresh edges after in-place updates
+        G::CsrGraph view = g.freeze();
+        G::DomTree expected{};
+        expected.build(view.index(1), view);
+        G::DomFrontier expected_df{};
+        expected_df.build(expected, view);
+        const G::DomFrontier &df = g.dom_frontier(1);
+        for (G::idx_t i = 0; i < view.size(); ++i) {
+            std::set<G::idx_t> got(df.frontier_begin(i), df.frontier_end(i));
+            std::set<G::idx_t> want(expected_df.frontier_begin(i), expected_df.frontier_end(i));
+            REQUIRE(got == want);
+        }
+    }
+    // edits w/o queries: a few are applied in place, past the limit the tree is rebuilt
+    for (size_t edits : {size_t{3}, size_t{3 * G::DomTree::PENDING_LIMIT}}) {
+        G::Graph<int, int> g{};
+        int value{0};
+        const G::key_t n = 40;
+        REQUIRE(g.add_nodes(value, n) != G::KEY_UNDEF);
+        for (G::key_t i = 1; i < n; ++i) {
+            REQUIRE(g.add_edge(0, i, i + 1) != G::KEY_UNDEF);
+        }
+        REQUIRE(g.dom_tree(1).updates() == 0);
+        // each shortcut from the root moves a node under it
+        for (size_t i = 0; i < edits; ++i) {
+            REQUIRE(g.add_edge(0, 1, static_cast<G::key_t>(i + 3)) != G::KEY_UNDEF);
+        }
+        const G::DomTree &tree = g.dom_tree(1);
+        REQUIRE(tree.updates() == (edits < G::DomTree::PENDING_LIMIT ? edits : 0));
+        G::CsrGraph view = g.freeze();
+        G::DomTree expected{};
+        expected.build(view.index(1), view);
+        REQUIRE(tree.size() == expected.size());
+        REQUIRE(tree.pending() == 0);
+        for (G::idx_t i = 0; i < view.size(); ++i) {
+            REQUIRE(tree.idom(i) == expected.idom(i));
+            REQUIRE(tree.depth(i) == expected.depth(i));
+        }
+    }
+}
+
 TEST_CASE("Test graph buffer", "[Gbuf1]") {
 
     G::Graph<int, int> g{};
@@ -575,17 +1074,363 @@ TEST_CASE("Test loop", "[LOOPS_1]") {
     //     }
     // }
     // std::cout << loops.dump();
-    Analysis::buildLoopTree(&g, &loops);
+    std::vector<G::Cycle> cycles{};
+    Analysis::buildLoopTree(&g, &loops, cycles);
     std::cout << loops.dump();
-    #if 0
-    std::cout << "Blocks:\n";
-    for (auto it = loops.nodes_begin(); it != loops.nodes_end(); ++it) {
-        std::cout << "loop: " << it->first << " ";
-        for (auto &block: it->second->data().blocks) {
-            std::cout << block << "\t";
+
+    // 1 <- 8 encloses 2 <- 7; 10 <-> 11 is entered from 9 at both nodes
+    std::map<G::key_t, G::key_t> innermost{{1, 1}, {2, 2}, {3, 2}, {4, 2}, {5, 2}, {6, 2},
+                                           {7, 2}, {8, 1}, {9, G::KEY_UNDEF}, {10, 10}, {11, 10}};
+    for (auto &item : innermost) {
+        REQUIRE(g.at(item.first)->get_loop() == item.second);
+    }
+    const G::key_t root_loop = 12;
+    REQUIRE(loops.get_node_count() == 4);
+    REQUIRE(loops.at(1)->data().is_reducible);
+    REQUIRE(loops.at(1)->data().back_edge_start == 8);
+    REQUIRE(loops.at(1)->data().back_edge == g.get_edge_id(8, 1));
+    REQUIRE(loops.at(2)->data().is_reducible);
+    REQUIRE(loops.at(2)->data().back_edge_start == 7);
+    REQUIRE(!loops.at(10)->data().is_reducible);
+    REQUIRE(loops.at(10)->data().back_edge_start == 11);
+    REQUIRE(loops.get_edge_id(root_loop, 1) != G::KEY_UNDEF);
+    REQUIRE(loops.get_edge_id(root_loop, 10) != G::KEY_UNDEF);
+    REQUIRE(loops.get_edge_id(1, 2) != G::KEY_UNDEF);
+    REQUIRE(loops.at(1)->data().blocks == std::vector<G::key_t>{1, 8});
+    REQUIRE(loops.at(2)->data().blocks == std::vector<G::key_t>{2, 3, 4, 5, 6, 7});
+    REQUIRE(loops.at(10)->data().blocks == std::vector<G::key_t>{10, 11});
+    REQUIRE(loops.at(root_loop)->data().blocks == std::vector<G::key_t>{9});
+    REQUIRE(loops.get_tree_lca(root_loop, 2, 10) == root_loop);
+    REQUIRE(loops.get_tree_lca(root_loop, 2, 1) == 1);
+    REQUIRE(loops.get_tree_lca(root_loop, 2, 2) == 2);
+    REQUIRE(loops.get_tree_lca(1, 2, 10) == G::KEY_UNDEF);
+
+    // loop info queries
+    std::map<G::key_t, size_t> depths{{1, 1}, {2, 2}, {5, 2}, {7, 2}, {8, 1}, {9, 0}, {10, 1}};
+    for (auto &item : depths) {
+        REQUIRE(g.get_loop_depth(1, item.first) == item.second);
+    }
+    REQUIRE(g.get_loop_header(1, 6) == 2);
+    REQUIRE(g.get_loop_header(1, 9) == G::KEY_UNDEF);
+    REQUIRE(g.get_latches(1, 1) == std::vector<G::key_t>{8});
+    REQUIRE(g.get_latches(1, 2) == std::vector<G::key_t>{7});
+    REQUIRE(g.get_latches(1, 10) == std::vector<G::key_t>{11});
+    REQUIRE(g.get_loop_exits(1, 1) == std::vector<G::EdgeEndsT>{{3, 9}});
+    REQUIRE(g.get_loop_exits(1, 2) == std::vector<G::EdgeEndsT>{{3, 9}, {7, 8}});
+    REQUIRE(g.get_loop_exits(1, 10).empty());
+    REQUIRE(g.get_preheader(1, 2) == 1);
+    REQUIRE(g.get_preheader(1, 1) == G::KEY_UNDEF);
+    REQUIRE(g.get_preheader(1, 10) == G::KEY_UNDEF);
+    // cache follows edits: 9 -> 1 makes 9 part of the outer loop
+    REQUIRE(g.add_edge(0, 9, 1) != G::KEY_UNDEF);
+    REQUIRE(g.get_loop_depth(1, 9) == 1);
+    REQUIRE(g.get_latches(1, 1) == std::vector<G::key_t>{8, 9});
+}
+
+TEST_CASE("Test loop forest", "[LOOPS_2]") {
+    // random graphs: a node is in a loop iff it is on a cycle, loop members are strongly
+    // connected w/ the header, inner loops are inside outer ones
+    std::mt19937 rng{14};
+    for (int round = 0; round < 50; ++round) {
+        G::Graph<int, int> g{};
+        int value{0};
+        const G::key_t n = 25;
+        REQUIRE(g.add_nodes(value, n) != G::KEY_UNDEF);
+        std::uniform_int_distribution<G::key_t> pick{1, n};
+        for (int i = 0; i < 40; ++i) {
+            g.add_edge(0, pick(rng), pick(rng));
+        }
+        G::CsrGraph view = g.freeze();
+        G::LoopForest forest{};
+        forest.build(view.index(1), view);
+        for (G::key_t x = 1; x <= n; ++x) {
+            G::idx_t node = view.index(x);
+            bool on_cycle{false};
+            for (auto it = g.at(x)->successors_begin(); it != g.at(x)->successors_end(); ++it) {
+                on_cycle = on_cycle || g.hasPath(it->first, x);
+            }
+            if (!g.hasPath(1, x)) {
+                REQUIRE(forest.loop(node) == G::IDX_UNDEF);
+                continue;
+            }
+            REQUIRE((forest.loop(node) != G::IDX_UNDEF) == on_cycle);
+            for (G::idx_t h = forest.loop(node); h != G::IDX_UNDEF; h = forest.parent(h)) {
+                REQUIRE(forest.is_header(h));
+                REQUIRE(g.hasPath(view.key(h), x));
+                REQUIRE(g.hasPath(x, view.key(h)));
+            }
+        }
+        // irreducible iff some member is entered from outside, bypassing header
+        for (G::idx_t h : forest.headers()) {
+            bool other_entry{false};
+            for (G::idx_t node = 0; node < view.size(); ++node) {
+                bool inside{false};
+                for (G::idx_t l = forest.loop(node); l != G::IDX_UNDEF; l = forest.parent(l)) {
+                    inside = inside || l == h;
+                }
+                if (!inside || node == h) {
+                    continue;
+                }
+                for (auto *it = view.predecessors_begin(node); it != view.predecessors_end(node);
+                     ++it) {
+                    bool pred_inside{false};
+                    for (G::idx_t l = forest.loop(*it); l != G::IDX_UNDEF; l = forest.parent(l)) {
+                        pred_inside = pred_inside || l == h;
+                    }
+                    other_entry = other_entry || (!pred_inside && g.hasPath(1, view.key(*it)));
+                }
+            }
+            REQUIRE(forest.is_irreducible(h) == other_entry);
+        }
+
+        // loop info agrees w/ forest chains
+        G::LoopInfo info{};
+        info.build(view.index(1), view);
+        auto inside = [&forest](G::idx_t header, G::idx_t node) {
+            for (G::idx_t l = forest.loop(node); l != G::IDX_UNDEF; l = forest.parent(l)) {
+                if (l == header) {
+                    return true;
+                }
+            }
+            return false;
+        };
+        for (G::idx_t node = 0; node < view.size(); ++node) {
+            G::idx_t depth{0};
+            for (G::idx_t l = forest.loop(node); l != G::IDX_UNDEF; l = forest.parent(l)) {
+                ++depth;
+            }
+            REQUIRE(info.depth(node) == depth);
+            for (G::idx_t h : forest.headers()) {
+                REQUIRE(info.contains(h, node) == inside(h, node));
+            }
+        }
+        for (G::idx_t h : forest.headers()) {
+            std::vector<G::idx_t> latches{};
+            for (auto *it = view.predecessors_begin(h); it != view.predecessors_end(h); ++it) {
+                if (inside(h, *it)) {
+                    latches.push_back(*it);
+                }
+            }
+            REQUIRE(std::vector<G::idx_t>(info.latches_begin(h), info.latches_end(h)) == latches);
+            size_t exits{0};
+            for (G::idx_t node = 0; node < view.size(); ++node) {
+                for (auto *it = view.successors_begin(node); it != view.successors_end(node); ++it) {
+                    exits += inside(h, node) && !inside(h, *it);
+                }
+            }
+            REQUIRE(static_cast<size_t>(info.exits_end(h) - info.exits_begin(h)) == exits);
         }
-        std::cout << std::endl;
     }
-    std::cout << std::endl;
-#endif
-}
\ No newline at end of file
+}
+
+TEST_CASE("Test scc", "[SCC_1]") {
+    G::Graph<int, int> g{};
+    int value{0};
+    REQUIRE(g.add_nodes(value, 7) != G::KEY_UNDEF);
+    // {1, 2, 3} -> {4, 5} -> 6, 3 -> 6, 7 alone
+    g.add_edge(0, 1, 2);
+    g.add_edge(0, 2, 3);
+    g.add_edge(0, 3, 1);
+    g.add_edge(0, 3, 4);
+    g.add_edge(0, 2, 4);
+    g.add_edge(0, 4, 5);
+    g.add_edge(0, 5, 4);
+    g.add_edge(0, 5, 6);
+    g.add_edge(0, 3, 6);
+    auto scc = g.get_scc();
+    REQUIRE(scc.size() == 7);
+    REQUIRE(scc[1] == scc[2]);
+    REQUIRE(scc[1] == scc[3]);
+    REQUIRE(scc[4] == scc[5]);
+    REQUIRE(scc[1] != scc[4]);
+    REQUIRE(scc[6] != scc[4]);
+    REQUIRE(scc[7] != scc[1]);
+
+    G::Graph<std::vector<G::key_t>, int> dag{};
+    std::vector<std::vector<G::key_t>> members{};
+    g.condense(scc, dag, members);
+    REQUIRE(dag.get_node_count() == 4);
+    REQUIRE(dag.freeze().edge_count() == 3);
+    REQUIRE(dag.at(scc[1])->data() == std::vector<G::key_t>{1, 2, 3});
+    REQUIRE(dag.at(scc[4])->data() == std::vector<G::key_t>{4, 5});
+    REQUIRE(dag.get_edge_id(scc[1], scc[4]) != G::KEY_UNDEF);
+    REQUIRE(dag.get_edge_id(scc[1], scc[6]) != G::KEY_UNDEF);
+    REQUIRE(dag.get_edge_id(scc[4], scc[6]) != G::KEY_UNDEF);
+
+    // random graphs: same component iff mutually reachable, dag edges go to smaller ids
+    std::mt19937 rng{17};
+    for (int round = 0; round < 30; ++round) {
+        G::Graph<int, int> r{};
+        const G::key_t n = 20;
+        REQUIRE(r.add_nodes(value, n) != G::KEY_UNDEF);
+        std::uniform_int_distribution<G::key_t> pick{1, n};
+        for (int i = 0; i < 30; ++i) {
+            r.add_edge(0, pick(rng), pick(rng));
+        }
+        auto ids = r.get_scc();
+        for (G::key_t a = 1; a <= n; ++a) {
+            for (G::key_t b = 1; b <= n; ++b) {
+                bool same = a == b || (r.hasPath(a, b) && r.hasPath(b, a));
+                REQUIRE((ids[a] == ids[b]) == same);
+            }
+        }
+        G::Graph<std::vector<G::key_t>, int> cond{};
+        std::vector<std::vector<G::key_t>> parts{};
+        r.condense(ids, cond, parts);
+        size_t total{0};
+        for (auto it = cond.nodes_begin(); it != cond.nodes_end(); ++it) {
+            total += it->second->data().size();
+            for (auto succ = it->second->successors_begin(); succ != it->second->successors_end();
+                 ++succ) {
+                REQUIRE(succ->first < it->first);
+            }
+        }
+        REQUIRE(total == static_cast<size_t>(n));
+    }
+}
+
+TEST_CASE("Test reachability", "[REACH_1]") {
+    // random graphs: both index kinds agree w/ DFS
+    std::mt19937 rng{18};
+    int value{0};
+    for (int round = 0; round < 40; ++round) {
+        G::Graph<int, int> g{};
+        const G::key_t n = 30;
+        REQUIRE(g.add_nodes(value, n) != G::KEY_UNDEF);
+        std::uniform_int_distribution<G::key_t> pick{1, n};
+        // mostly forward edges, so that the condensation keeps some depth
+        for (int i = 0; i < 45; ++i) {
+            G::key_t a = pick(rng);
+            G::key_t b = pick(rng);
+            g.add_edge(0, (i % 5 == 0) ? std::max(a, b) : std::min(a, b),
+                       (i % 5 == 0) ? std::min(a, b) : std::max(a, b));
+        }
+        G::CsrGraph view = g.freeze();
+        G::Reachability bits{};
+        bits.build(view);
+        G::Reachability intervals{};
+        intervals.build(view, 0);
+        REQUIRE(bits.is_bitset());
+        REQUIRE(!intervals.is_bitset());
+        for (G::key_t a = 1; a <= n; ++a) {
+            for (G::key_t b = 1; b <= n; ++b) {
+                bool path = g.hasPath(a, b);
+                REQUIRE(bits.reaches(view.index(a), view.index(b)) == path);
+                REQUIRE(intervals.reaches(view.index(a), view.index(b)) == path);
+                REQUIRE(g.reachable(a, b) == path);
+            }
+        }
+    }
+
+    // index follows graph changes
+    G::Graph<int, int> g{};
+    REQUIRE(g.add_nodes(value, 3) != G::KEY_UNDEF);
+    g.add_edge(0, 1, 2);
+    REQUIRE(g.reachable(1, 2));
+    REQUIRE(!g.reachable(1, 3));
+    REQUIRE(!g.reachable(1, 4));
+    g.add_edge(0, 2, 3);
+    REQUIRE(g.reachable(1, 3));
+    REQUIRE(!g.reachable(3, 1));
+}
+
+TEST_CASE("Test nearest common dominator", "[DOM_TREE_8]") {
+    // forest by parents: 0 -> {1, 2}, 1 -> {3, 4}, 4 -> 5; 6 -> 7
+    G::LcaIndex index{};
+    const G::idx_t U = G::IDX_UNDEF;
+    index.build({U, 0, 0, 1, 1, 4, U, 6});
+    REQUIRE(index.lca(3, 5) == 1);
+    REQUIRE(index.lca(5, 3) == 1);
+    REQUIRE(index.lca(5, 2) == 0);
+    REQUIRE(index.lca(4, 5) == 4);
+    REQUIRE(index.lca(0, 0) == 0);
+    REQUIRE(index.lca(7, 6) == 6);
+    REQUIRE(index.lca(7, 5) == G::IDX_UNDEF);
+    REQUIRE(index.lca(7, 8) == G::IDX_UNDEF);
+
+    // random graphs: agrees w/ NCA walk of dominator tree
+    std::mt19937 rng{19};
+    int value{0};
+    for (int round = 0; round < 30; ++round) {
+        G::Graph<int, int> g{};
+        const G::key_t n = 40;
+        REQUIRE(g.add_nodes(value, n) != G::KEY_UNDEF);
+        std::uniform_int_distribution<G::key_t> pick{1, n};
+        for (int i = 0; i < 60; ++i) {
+            g.add_edge(0, pick(rng), pick(rng));
+        }
+        G::CsrGraph view = g.freeze();
+        G::DomTree tree{};
+        tree.build(view.index(1), view);
+        for (G::key_t a = 1; a <= n; ++a) {
+            for (G::key_t b = 1; b <= n; ++b) {
+                G::idx_t want = tree.nca(view.index(a), view.index(b));
+                G::key_t got = g.get_nearest_common_dominator(1, a, b);
+                REQUIRE(got == ((want == G::IDX_UNDEF) ? G::KEY_UNDEF : view.key(want)));
+            }
+        }
+    }
+}
+
+TEST_CASE("Test graph builder", "[BUILD_1]") {
+    // same graph as from add_node/add_edge calls
+    std::mt19937 rng{20};
+    int value{0};
+    const G::key_t n = 50;
+    std::uniform_int_distribution<G::key_t> pick{1, n};
+    std::vector<G::EdgeEndsT> ends{};
+    std::set<G::EdgeEndsT> seen{};
+    for (int i = 0; i < 120; ++i) {
+        G::EdgeEndsT edge{pick(rng), pick(rng)};
+        if (seen.insert(edge).second) {
+            ends.push_back(edge);
+        }
+    }
+    G::Graph<int, int> expected{};
+    REQUIRE(expected.add_nodes(value, n) != G::KEY_UNDEF);
+    G::GraphBuilder<int, int> builder{};
+    builder.reserve(n, ends.size());
+    for (G::key_t i = 0; i < n; ++i) {
+        builder.add_node(value);
+    }
+    for (auto &edge : ends) {
+        REQUIRE(expected.add_edge(0, edge.first, edge.second) != G::KEY_UNDEF);
+        builder.add_edge(0, edge.first, edge.second);
+    }
+    G::Graph<int, int> g{};
+    REQUIRE(builder.build(g) == n);
+    REQUIRE(g.dump() == expected.dump());
+    for (G::key_t x = 1; x <= n; ++x) {
+        auto *node = g.at(x);
+        auto *want = expected.at(x);
+        REQUIRE(node->get_successor_count() == want->get_successor_count());
+        REQUIRE(node->get_predecessor_count() == want->get_predecessor_count());
+        REQUIRE(std::equal(node->successors_begin(), node->successors_end(),
+                           want->successors_begin(),
+                           [](auto &a, auto &b) { return a.first == b.first; }));
+        REQUIRE(std::equal(node->predecessors_begin(), node->predecessors_end(),
+                           want->predecessors_begin(),
+                           [](auto &a, auto &b) { return a.first == b.first; }));
+        REQUIRE(node->out_edges().size() == want->out_edges().size());
+        REQUIRE(g.get_idom(1, x) == expected.get_idom(1, x));
+    }
+    // graph stays editable
+    REQUIRE(g.add_node(value) == n + 1);
+    REQUIRE(g.add_edge(0, n, n + 1) != G::KEY_UNDEF);
+    REQUIRE(g.get_edge_id(n, n + 1) == static_cast<G::key_t>(ends.size()) + 1);
+
+    // errors leave graph untouched
+    G::Graph<int, int> h{};
+    builder.add_node(value);
+    builder.add_node(value);
+    builder.add_edge(0, 1, 2);
+    builder.add_edge(0, 1, 2);
+    REQUIRE(builder.build(h) == G::KEY_UNDEF);
+    REQUIRE(h.get_node_count() == 0);
+    builder.clear();
+    builder.add_node(value, 5);
+    builder.add_edge(0, 5, 6);
+    REQUIRE(builder.build(h) == G::KEY_UNDEF);
+    REQUIRE(h.get_node_count() == 0);
+    REQUIRE(builder.build(g) == G::KEY_UNDEF);
+}
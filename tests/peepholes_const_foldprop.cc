@@ -160,4 +160,233 @@ TEST_CASE("Test peepholes 2", "[peepholes2]") {
     doPeepholes(g, instrs);
 
     std::cerr << g.dump();
-}
\ No newline at end of file
+}
+
+/*
+Use-lists: operand slots are linked into use-list of their definition
+*/
+TEST_CASE("Test use lists", "[uses1]") {
+    IR::BasicBlockManager bbs{};
+    IR::InstrManager instrs{};
+    auto *bb0 = bbs.create();
+    auto *c0 = instrs.createCONST(IR::ValueHolder(1, IR::NO_VALUEHOLDER));
+    auto *c1 = instrs.createCONST(IR::ValueHolder(2, IR::NO_VALUEHOLDER));
+    auto *i0 = instrs.createADD({});
+    auto *i1 = instrs.createADD({});
+    auto *phy = instrs.create();
+    auto inputs = [](IR::InstrBase *instr) {
+        return std::vector<IR::InstrBase *>(instr->inputs_begin(), instr->inputs_end());
+    };
+
+    bb0->push_phys({phy});
+    bb0->push_instrs({c0, c1, i0, i1});
+    i0->push_inputs({c0, c1});
+    i1->push_inputs({i0, c0});
+    REQUIRE(c0->user_count() == 2);
+    REQUIRE(i0->user_count() == 1);
+    REQUIRE(*i0->users_begin() == i1);
+    i0->throwIfWrongDeps_();
+    c0->throwIfWrongDeps_();
+
+    // spill past inline operands keeps use-lists intact
+    phy->push_inputs({c0, c1, i0, i1, c0});
+    REQUIRE(inputs(phy) == std::vector<IR::InstrBase *>{c0, c1, i0, i1, c0});
+    REQUIRE(c0->user_count() == 4);
+    REQUIRE(i1->user_count() == 1);
+    c0->throwIfWrongDeps_();
+    c1->throwIfWrongDeps_();
+    phy->throwIfWrongDeps_();
+
+    // positional erase shifts operands left
+    phy->erase_input(size_t{1});
+    REQUIRE(inputs(phy) == std::vector<IR::InstrBase *>{c0, i0, i1, c0});
+    REQUIRE(c1->user_count() == 1);
+
+    // set moves one use between definitions
+    phy->input_use(0).set(c1);
+    REQUIRE(phy->input(0) == c1);
+    REQUIRE(c0->user_count() == 3);
+    REQUIRE(c1->user_count() == 2);
+    c0->throwIfWrongDeps_();
+    c1->throwIfWrongDeps_();
+
+    // drop_users clears every operand slot referring to c0
+    c0->drop_users();
+    REQUIRE(c0->user_count() == 0);
+    REQUIRE(inputs(i0) == std::vector<IR::InstrBase *>{c1});
+    REQUIRE(inputs(i1) == std::vector<IR::InstrBase *>{i0});
+    REQUIRE(inputs(phy) == std::vector<IR::InstrBase *>{c1, i0, i1});
+
+    phy->drop_inputs();
+    REQUIRE(phy->input_count() == 0);
+    REQUIRE(i1->user_count() == 0);
+    REQUIRE(i0->user_count() == 1);
+    REQUIRE(c1->user_count() == 1);
+}
+
+TEST_CASE("Test operand rewrite", "[uses2]") {
+    IR::BasicBlockManager bbs{};
+    IR::InstrManager instrs{};
+    auto *bb0 = bbs.create();
+    auto *c0 = instrs.createCONST(IR::ValueHolder(1, IR::NO_VALUEHOLDER));
+    auto *c1 = instrs.createCONST(IR::ValueHolder(2, IR::NO_VALUEHOLDER));
+    auto *i0 = instrs.createADD({});
+    auto *i1 = instrs.createADD({});
+    auto *i2 = instrs.createXOR({});
+    bb0->push_instrs({c0, c1, i0, i1, i2});
+    auto inputs = [](IR::InstrBase *instr) {
+        return std::vector<IR::InstrBase *>(instr->inputs_begin(), instr->inputs_end());
+    };
+
+    i0->push_inputs({c0, c1});
+    i1->push_inputs({i0, c0});
+    i2->push_inputs({c0, i0});
+
+    // operand keeps its position
+    i1->setOperand(1, c1);
+    REQUIRE(inputs(i1) == std::vector<IR::InstrBase *>{i0, c1});
+    REQUIRE(c0->user_count() == 2);
+    REQUIRE(c1->user_count() == 2);
+    REQUIRE_THROWS(i1->setOperand(2, c1));
+    REQUIRE_THROWS(i1->setOperand(0, nullptr));
+
+    // every use of i0 goes to c1, positions included
+    i0->replaceAllUsesWith(c1);
+    REQUIRE(i0->user_count() == 0);
+    REQUIRE(c1->user_count() == 4);
+    REQUIRE(inputs(i1) == std::vector<IR::InstrBase *>{c1, c1});
+    REQUIRE(inputs(i2) == std::vector<IR::InstrBase *>{c0, c1});
+    REQUIRE(inputs(i0) == std::vector<IR::InstrBase *>{c0, c1});
+    c1->throwIfWrongDeps_();
+    i1->throwIfWrongDeps_();
+
+    i1->replaceAllUsesWith(i1);
+    c0->replaceAllUsesWith(c0);
+    REQUIRE(c0->user_count() == 2);
+}
+
+TEST_CASE("Test instr list", "[instrs1]") {
+    IR::BasicBlockManager bbs{};
+    IR::InstrManager instrs{};
+    auto *bb0 = bbs.create();
+    auto *bb1 = bbs.create();
+    auto *c0 = instrs.createCONST(IR::ValueHolder(1, IR::NO_VALUEHOLDER));
+    auto *c1 = instrs.createCONST(IR::ValueHolder(2, IR::NO_VALUEHOLDER));
+    auto *c2 = instrs.createCONST(IR::ValueHolder(3, IR::NO_VALUEHOLDER));
+    auto *c3 = instrs.createCONST(IR::ValueHolder(4, IR::NO_VALUEHOLDER));
+    auto *c4 = instrs.createCONST(IR::ValueHolder(5, IR::NO_VALUEHOLDER));
+    auto list = [](IR::BasicBlock *bb) {
+        return std::vector<IR::Instr *>(bb->instr_begin(), bb->instr_end());
+    };
+
+    bb0->push_instrs({c0, c2});
+    REQUIRE(*bb0->insert_before(c2, c1) == c1);
+    REQUIRE(*bb0->insert_after(c2, c4) == c4);
+    REQUIRE(*bb0->insert_after(nullptr, c3) == c3);
+    REQUIRE(list(bb0) == std::vector<IR::Instr *>{c3, c0, c1, c2, c4});
+    REQUIRE(*--bb0->instr_end() == c4);
+    REQUIRE(bb0->is_before(c3, c0));
+    REQUIRE_THROWS(bb0->insert_before(c0, c1));
+    bb0->throwIfNotConsistent_();
+
+    // O(1) unlink, iterator to the next instr
+    REQUIRE(*bb0->unlink_instr(c3) == c0);
+    REQUIRE(*bb0->unlink_instr(c4) == nullptr);
+    REQUIRE(c4->bb() == nullptr);
+    REQUIRE(bb0->instr_count() == 3);
+    REQUIRE(*bb0->instr_last() == c2);
+
+    // range moves to other bb
+    bb1->push_instrs({c3, c4});
+    bb1->splice(c4, *bb0, c0, c1);
+    REQUIRE(list(bb0) == std::vector<IR::Instr *>{c2});
+    REQUIRE(list(bb1) == std::vector<IR::Instr *>{c3, c0, c1, c4});
+    REQUIRE(c0->bb() == bb1);
+    REQUIRE(bb0->instr_count() == 1);
+    REQUIRE(bb1->instr_count() == 4);
+    REQUIRE(bb1->is_before(c1, c4));
+    bb1->splice(nullptr, *bb0, c2, c2);
+    REQUIRE(bb0->instr_begin() == bb0->instr_end());
+    REQUIRE(*bb1->instr_last() == c2);
+    bb0->throwIfNotConsistent_();
+    bb1->throwIfNotConsistent_();
+}
+
+TEST_CASE("Test instr index", "[index1]") {
+    IR::BasicBlockManager bbs{};
+    IR::InstrManager instrs{};
+    auto *bb0 = bbs.create();
+    auto *bb1 = bbs.create();
+    auto *c0 = instrs.createCONST(IR::ValueHolder(1, IR::NO_VALUEHOLDER));
+    auto *c1 = instrs.createCONST(IR::ValueHolder(2, IR::NO_VALUEHOLDER));
+    auto *i0 = instrs.createADD({});
+    auto *c2 = instrs.create(IR::OpcodeType::ICONST, IR::GroupType::CONST,
+                             IR::ValueHolder(3, IR::NO_VALUEHOLDER), 100);
+    i0->push_inputs({c0, c1});
+
+    REQUIRE(instrs.get(c0->get_id()) == c0);
+    REQUIRE(instrs.get(i0->get_id()) == i0);
+    REQUIRE(instrs.get(100) == c2);
+    REQUIRE(instrs.get(99) == nullptr);
+    REQUIRE(instrs.get(IR::ID_UNDEF) == nullptr);
+    REQUIRE(instrs.get_bb(c0->get_id()) == nullptr);
+
+    bb0->push_instrs({c0, c1, c2});
+    bb1->push_instrs({i0});
+    REQUIRE(instrs.get_bb(c1->get_id()) == bb0);
+    REQUIRE(instrs.get_bb(i0->get_id()) == bb1);
+
+    // cut & push again
+    REQUIRE(bb0->cut_instr(c1->get_id()).second == c1);
+    REQUIRE(instrs.get_bb(c1->get_id()) == nullptr);
+    bb1->push_instrs({c1});
+    REQUIRE(instrs.get_bb(c1->get_id()) == bb1);
+
+    // erase by instr found through the index
+    auto *found = static_cast<IR::Instr *>(instrs.get(c0->get_id()));
+    REQUIRE_FALSE(bb0->erase_unused_instr(found));
+    REQUIRE(*bb0->erase_instr(found) == c2);
+    REQUIRE(instrs.get_bb(c0->get_id()) == nullptr);
+    REQUIRE(i0->input_count() == 1);
+    REQUIRE(bb0->erase_unused_instr(c2));
+    REQUIRE(bb0->instr_count() == 0);
+    bb0->throwIfNotConsistent_();
+}
+
+TEST_CASE("Test arena managers", "[arena1]") {
+    IR::Arena arena{IR::Arena::ChunkSource::HEAP, 4096};
+    auto *a = static_cast<char *>(arena.allocate(3, 1));
+    auto *b = arena.allocate(8, 8);
+    REQUIRE(reinterpret_cast<uintptr_t>(b) % 8 == 0);
+    REQUIRE(static_cast<char *>(b) >= a + 3);
+    REQUIRE(arena.chunk_count() == 1);
+    // oversized allocation keeps the current chunk open
+    arena.allocate(10000, 16);
+    REQUIRE(arena.chunk_count() == 2);
+    auto *c = static_cast<char *>(arena.allocate(8, 8));
+    REQUIRE(c == static_cast<char *>(b) + 8);
+    arena.release();
+    REQUIRE(arena.chunk_count() == 0);
+
+    for (auto source : {IR::Arena::ChunkSource::HEAP, IR::Arena::ChunkSource::HUGE_PAGES}) {
+        IR::BasicBlockManager bbs{source};
+        IR::InstrManager instrs{source};
+        auto *bb = bbs.create();
+        auto *c0 = instrs.createCONST(IR::ValueHolder(1, IR::NO_VALUEHOLDER));
+        bb->push_instrs({c0});
+        IR::Instr *prev = c0;
+        for (int i = 0; i < 100000; ++i) {
+            auto *instr = instrs.createADD({});
+            instr->push_inputs({prev, c0});
+            bb->push_instrs({instr});
+            prev = instr;
+        }
+        // spilled operands are freed by the manager
+        auto *phy = instrs.create();
+        phy->push_inputs({c0, prev, c0, prev});
+        bb->push_phys({phy});
+        REQUIRE(bb->instr_count() == 100001);
+        REQUIRE(c0->user_count() == 100003);
+        REQUIRE(instrs.get(prev->get_id()) == prev);
+    }
+}